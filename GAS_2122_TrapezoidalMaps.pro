@@ -19,8 +19,36 @@ FINAL_RELEASE {
     }
 }
 
-# cg3lib works with c++11
-CONFIG += c++11
+# cg3lib works with c++11, std::pmr memory resources need c++17
+CONFIG += c++17
+
+# Uncomment next line to select another point locator at startup (0: directed acyclic graph, 1: slab decomposition,
+# 2: persistent search tree), it can also be changed in the manager
+#DEFINES += POINT_LOCATOR=1
+
+# Uncomment next line to let the queries of the directed acyclic graph start from the entry node of a grid cell
+# (the value is the number of cells on each side of the bounding box)
+#DEFINES += ENTRY_GRID_RESOLUTION=256
+
+# Uncomment next line to compare the query time of all point locators on random queries at the first query after the map
+# changes (see the console)
+#CONFIG += COMPARE_POINT_LOCATORS
+
+COMPARE_POINT_LOCATORS {
+    DEFINES += COMPARE_POINT_LOCATORS
+}
+
+# Uncomment next line to compute the corners of four trapezoids at once with AVX2 when the vertex arrays are updated
+# (the binary then needs a processor with AVX2, otherwise the corners are computed one trapezoid at a time)
+#CONFIG += AVX2
+
+AVX2 {
+    unix: QMAKE_CXXFLAGS += -mavx2
+    win32: QMAKE_CXXFLAGS += /arch:AVX2
+}
+
+# std::thread is used to build the slabs of the partitioned trapezoidal map and to load the segments in the manager
+unix: LIBS += -lpthread
 
 # Cg3lib configuration. Available options:
 #
@@ -36,19 +64,39 @@ CONFIG += CG3_CORE CG3_VIEWER
 include (cg3lib/cg3.pri)
 message($$MODULES)
 
+# cg3lib is written for c++11 and its iterators derive from std::iterator, which is deprecated in c++17: its headers are included as
+# system headers, so only the warnings of this project are reported
+unix: QMAKE_CXXFLAGS += -isystem $$PWD/cg3lib
+win32-msvc*: DEFINES += _SILENCE_CXX17_ITERATOR_BASE_CLASS_DEPRECATION_WARNING
+
 DISTFILES += \
     LICENSE
 
 SOURCES +=  \
     algorithms/algorithms.cpp \
+    data_structures/construction_context.cpp \
     data_structures/directed_acyclic_graph.cpp \
+    data_structures/entry_grid.cpp \
+    data_structures/geometry_store.cpp \
+    data_structures/latency_histogram.cpp \
+    data_structures/memory_usage.cpp \
     data_structures/node.cpp \
+    data_structures/partitioned_trapezoidalmap.cpp \
+    data_structures/persistent_search_tree.cpp \
+    data_structures/query_packet.cpp \
     data_structures/segment_intersection_checker.cpp \
+    data_structures/slab_decomposition.cpp \
     data_structures/trapezoid.cpp \
     data_structures/trapezoidalmap.cpp \
     data_structures/trapezoidalmap_dataset.cpp \
+    data_structures/trapezoidalmap_progress.cpp \
+    data_structures/versioned_trapezoidalmap.cpp \
     drawables/drawable_trapezoidalmap.cpp \
     drawables/drawable_trapezoidalmap_dataset.cpp \
+    locators/dag_point_locator.cpp \
+    locators/persistent_tree_point_locator.cpp \
+    locators/point_locator.cpp \
+    locators/slab_point_locator.cpp \
     main.cpp \
     managers/trapezoidalmap_manager.cpp \
     utils/fileutils.cpp \
@@ -59,14 +107,31 @@ FORMS += \
 
 HEADERS += \
     algorithms/algorithms.h \
+    data_structures/chunked_vector.h \
+    data_structures/construction_context.h \
     data_structures/directed_acyclic_graph.h \
+    data_structures/entry_grid.h \
+    data_structures/flat_hash_map.h \
+    data_structures/geometry_store.h \
+    data_structures/latency_histogram.h \
+    data_structures/memory_usage.h \
     data_structures/node.h \
+    data_structures/partitioned_trapezoidalmap.h \
+    data_structures/persistent_search_tree.h \
+    data_structures/query_packet.h \
     data_structures/segment_intersection_checker.h \
+    data_structures/slab_decomposition.h \
     data_structures/trapezoid.h \
     data_structures/trapezoidalmap.h \
     data_structures/trapezoidalmap_dataset.h \
+    data_structures/trapezoidalmap_progress.h \
+    data_structures/versioned_trapezoidalmap.h \
     drawables/drawable_trapezoidalmap.h \
     drawables/drawable_trapezoidalmap_dataset.h \
+    locators/dag_point_locator.h \
+    locators/persistent_tree_point_locator.h \
+    locators/point_locator.h \
+    locators/slab_point_locator.h \
     managers/trapezoidalmap_manager.h \
     utils/fileutils.h \
     utils/geometric_utils.h
@@ -1,6 +1,12 @@
 #include "algorithms.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
 #include <cg3/geometry/utils2.h>
+#include "data_structures/flat_hash_map.h"
 #include "utils/geometric_utils.h"
 
 /**
@@ -10,43 +16,581 @@
  * @param segment is the segment added to the data structures.
  */
 void algorithms::add(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Segment2d& segment) {
-    std::vector<size_t> intersectedTrapezoids;
+    ConstructionContext constructionContext;
 
-    const size_t& id = trapezoidalMap.addSegment(segment);
+    add(trapezoidalMap, directedAcyclicGraph, constructionContext, segment);
+}
 
+/**
+ * @brief algorithms::add allows updating the data structures with the new segment, using the scratch vectors of the construction context.
+ * Reusing the same context for every segment, the insertion allocates only when the data structures grow.
+ * A degenerate segment, or one already in the trapezoidal map, is skipped.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param constructionContext contains the scratch vectors of the construction.
+ * @param segment is the segment added to the data structures.
+ */
+void algorithms::add(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, ConstructionContext& constructionContext, const cg3::Segment2d& segment) {
+    std::vector<size_t>& intersectedTrapezoids = constructionContext.intersectedTrapezoids;
+
+    const size_t id = trapezoidalMap.addSegment(segment);
+
+    // the segment is degenerate or already in the trapezoidal map
+    if (id == std::numeric_limits<size_t>::max())
+        return;
+
+    intersectedTrapezoids.clear();
     followSegment(trapezoidalMap, directedAcyclicGraph, trapezoidalMap.getSegment(id), intersectedTrapezoids);
 
     if (intersectedTrapezoids.size() == 1)
-        update(trapezoidalMap, directedAcyclicGraph, id, intersectedTrapezoids[0]);
+        update(trapezoidalMap, directedAcyclicGraph, constructionContext, id, intersectedTrapezoids[0]);
     else
-        update(trapezoidalMap, directedAcyclicGraph, id, intersectedTrapezoids);
+        update(trapezoidalMap, directedAcyclicGraph, constructionContext, id, intersectedTrapezoids);
+}
+
+/**
+ * @brief algorithms::add allows a batch of segments to be added to the versioned trapezoidal map, and publishes the result as a new version.
+ * Readers keep querying the previous version while the batch is inserted. Degenerate segments, and segments already in the map or
+ * repeated in the batch, are skipped.
+ * @param versionedTrapezoidalMap contains the writer data structures and the published versions.
+ * @param segments are the segments added to the data structures.
+ */
+void algorithms::add(VersionedTrapezoidalMap& versionedTrapezoidalMap, const std::vector<cg3::Segment2d>& segments) {
+    std::lock_guard<std::mutex> lock(versionedTrapezoidalMap.getWriterMutex());
+    ConstructionContext constructionContext;
+
+    for (const cg3::Segment2d& segment : segments)
+        add(versionedTrapezoidalMap.getTrapezoidalMap(), versionedTrapezoidalMap.getDirectedAcyclicGraph(), constructionContext, segment);
+
+    versionedTrapezoidalMap.publish();
+}
+
+/**
+ * @brief algorithms::build allows the data structures to be built from scratch inserting the segments in a random order.
+ * The maximum depth of the directed acyclic graph is O(log n) only in expectation, so the construction is abandoned as soon as the depth
+ * exceeds depthFactor * log2(n + 1) and started again with a new random order, as in the Las Vegas version of the algorithm.
+ * @param trapezoidalMap contains all points, segments, and trapezoids, it is cleared before each construction.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes, it is cleared before each construction.
+ * @param segments are the segments added to the data structures.
+ * @param depthFactor is the factor of the logarithm which bounds the depth.
+ * @param maxBuilds is the maximum number of constructions, the last one is kept whatever its depth.
+ * @return the number of constructions.
+ */
+size_t algorithms::build(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const std::vector<cg3::Segment2d>& segments, const size_t& depthFactor, const size_t& maxBuilds) {
+    return build(trapezoidalMap, directedAcyclicGraph, segments, depthFactor, maxBuilds, std::function<bool()>());
+}
+
+/**
+ * @brief algorithms::build allows the data structures to be built from scratch inserting the segments in a random order, as the other build,
+ * calling a function after each insertion, so the construction can be followed and stopped by another thread.
+ * @param trapezoidalMap contains all points, segments, and trapezoids, it is cleared before each construction.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes, it is cleared before each construction.
+ * @param segments are the segments added to the data structures.
+ * @param depthFactor is the factor of the logarithm which bounds the depth.
+ * @param maxBuilds is the maximum number of constructions, the last one is kept whatever its depth.
+ * @param segmentAdded is called after each insertion, if it returns false the construction stops with the segments inserted so far.
+ * @return the number of constructions.
+ */
+size_t algorithms::build(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const std::vector<cg3::Segment2d>& segments, const size_t& depthFactor, const size_t& maxBuilds, const std::function<bool()>& segmentAdded) {
+    const size_t maxDepth = depthFactor * static_cast<size_t>(std::ceil(std::log2(static_cast<double>(segments.size()) + 1)));
+    std::vector<cg3::Segment2d> permutation(segments);
+    std::mt19937 randomGenerator(std::random_device{}());
+    ConstructionContext constructionContext;
+    size_t builds = 0;
+    bool built = false;
+
+    while (!built) {
+        std::shuffle(permutation.begin(), permutation.end(), randomGenerator);
+
+        trapezoidalMap.clear();
+        directedAcyclicGraph.clear();
+
+        built = true;
+        builds++;
+
+        for (const cg3::Segment2d& segment : permutation) {
+            add(trapezoidalMap, directedAcyclicGraph, constructionContext, segment);
+
+            if (segmentAdded && !segmentAdded())
+                return builds;
+
+            // the depth never decreases, so the construction can be abandoned as soon as it is too deep
+            if (directedAcyclicGraph.getMaxDepth() > maxDepth && builds < maxBuilds) {
+                built = false;
+                break;
+            }
+        }
+    }
+
+    return builds;
 }
 
 /**
  * @brief algorithms::query returns the trapezoid index where the query point is in, using the directed acyclig graph and the trapezoidal map.
+ * Points are compared lexicographically, so points sharing the x coordinate and vertical segments are handled as in a sheared plane.
  * @param trapezoidalMap contains all points, segments, and trapezoids.
  * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * Each node is copied once before it is tested, so the query can run while another thread adds segments: the directed acyclic graph
+ * always leads to a trapezoid of the map before or after the insertion, but the trapezoid itself may be rewritten meanwhile.
  * @param queryPoint is the point used to find the trapezoid which contains it.
  * @return the trapezoid index where the query point is in.
  */
 size_t algorithms::query(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Point2d& queryPoint) {
-    const std::vector<cg3::Point2d>& points = trapezoidalMap.getPoints();
-    const std::vector<Node>& nodes = directedAcyclicGraph.getNodes();
-    size_t id = 0;
+    return queryFrom(trapezoidalMap, directedAcyclicGraph, 0, queryPoint);
+}
 
-    while (nodes[id].getType() != Node::TRAPEZOID)
-        if (nodes[id].getType() == Node::POINT)
-            if (points[nodes[id].getObject()].x() > queryPoint.x())
-                id = nodes[id].getLeftChild();
+/**
+ * @brief algorithms::queryFrom returns the trapezoid index where the query point is in, following the directed acyclic graph from the given node.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param startNode is a node whose region contains the query point, the root contains all points.
+ * @param queryPoint is the point used to find the trapezoid which contains it.
+ * @return the trapezoid index where the query point is in.
+ */
+size_t algorithms::queryFrom(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& startNode, const cg3::Point2d& queryPoint) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<Node>& nodes = directedAcyclicGraph.getNodes();
+    Node node = nodes[startNode];
+
+    while (node.getType() != Node::TRAPEZOID) {
+        if (node.getType() == Node::POINT)
+            if (points[node.getObject()] > queryPoint)
+                node = nodes[node.getLeftChild()];
             else
-                id = nodes[id].getRightChild();
+                node = nodes[node.getRightChild()];
         else
-            if (cg3::isPointAtLeft(trapezoidalMap.getSegment(nodes[id].getObject()), queryPoint))
-                id = nodes[id].getLeftChild();
+            if (cg3::isPointAtLeft(trapezoidalMap.getSegment(node.getObject()), queryPoint))
+                node = nodes[node.getLeftChild()];
             else
-                id = nodes[id].getRightChild();
+                node = nodes[node.getRightChild()];
+    }
 
-    return nodes[id].getObject();
+    return node.getObject();
+}
+
+/**
+ * @brief algorithms::add allows updating the data structures with the new segment, then refines the cells of the entry grid which entered
+ * at the nodes of the intersected trapezoids, since those nodes are no longer leaves.
+ * A degenerate segment, or one already in the trapezoidal map, is skipped.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param entryGrid contains the entry node of each cell.
+ * @param constructionContext contains the scratch vectors of the construction.
+ * @param segment is the segment added to the data structures.
+ */
+void algorithms::add(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, EntryGrid& entryGrid, ConstructionContext& constructionContext, const cg3::Segment2d& segment) {
+    const ChunkedVector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
+    std::vector<size_t>& intersectedTrapezoids = constructionContext.intersectedTrapezoids;
+    std::vector<size_t>& splitNodes = constructionContext.splitNodes;
+    std::vector<size_t>& leafCells = constructionContext.leafCells;
+
+    const size_t id = trapezoidalMap.addSegment(segment);
+
+    // the segment is degenerate or already in the trapezoidal map
+    if (id == std::numeric_limits<size_t>::max())
+        return;
+
+    intersectedTrapezoids.clear();
+    followSegment(trapezoidalMap, directedAcyclicGraph, trapezoidalMap.getSegment(id), intersectedTrapezoids);
+
+    splitNodes.clear();
+    for (const size_t& trapezoid : intersectedTrapezoids)
+        splitNodes.push_back(trapezoids[trapezoid].getNode());
+
+    if (intersectedTrapezoids.size() == 1)
+        update(trapezoidalMap, directedAcyclicGraph, constructionContext, id, intersectedTrapezoids[0]);
+    else
+        update(trapezoidalMap, directedAcyclicGraph, constructionContext, id, intersectedTrapezoids);
+
+    for (const size_t& node : splitNodes) {
+        entryGrid.takeLeafCells(node, leafCells);
+        refine(entryGrid, trapezoidalMap, directedAcyclicGraph, leafCells);
+    }
+}
+
+/**
+ * @brief algorithms::build allows the entry grid to be built over the current directed acyclic graph.
+ * @param entryGrid contains the entry node of each cell.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param resolution is the number of cells on each side of the bounding box, 0 disables the grid.
+ */
+void algorithms::build(EntryGrid& entryGrid, const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& resolution) {
+    std::vector<size_t> cells;
+
+    entryGrid.initialize(resolution);
+
+    for (size_t cell = 0; cell < entryGrid.getCellNumber(); cell++)
+        cells.push_back(cell);
+
+    refine(entryGrid, trapezoidalMap, directedAcyclicGraph, cells);
+}
+
+/**
+ * @brief algorithms::refine allows the cells to enter deeper in the directed acyclic graph, starting from their current entry node.
+ * A cell follows a point node if all of it lies on one side of the point x coordinate, and a segment node if its four corners lie on the
+ * same side of the segment line: points reaching a segment node are inside the segment x range, where the line and the segment agree.
+ * @param entryGrid contains the entry node of each cell.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param cells are the cells to be refined.
+ */
+void algorithms::refine(EntryGrid& entryGrid, const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const std::vector<size_t>& cells) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<Node>& nodes = directedAcyclicGraph.getNodes();
+
+    for (const size_t& cell : cells) {
+        const cg3::BoundingBox2& cellBoundingBox = entryGrid.getCellBoundingBox(cell);
+        const cg3::Point2d corners[4] = {cellBoundingBox.min(), cg3::Point2d(cellBoundingBox.max().x(), cellBoundingBox.min().y()),
+                                         cellBoundingBox.max(), cg3::Point2d(cellBoundingBox.min().x(), cellBoundingBox.max().y())};
+        size_t node = entryGrid.getEntryNode(cell);
+        bool descending = true;
+
+        while (descending && nodes[node].getType() != Node::TRAPEZOID) {
+            descending = false;
+
+            if (nodes[node].getType() == Node::POINT) {
+                const double& x = points[nodes[node].getObject()].x();
+
+                if (cellBoundingBox.max().x() < x) {
+                    node = nodes[node].getLeftChild();
+                    descending = true;
+                }
+                else if (cellBoundingBox.min().x() > x) {
+                    node = nodes[node].getRightChild();
+                    descending = true;
+                }
+            }
+            else {
+                const cg3::Segment2d& segment = trapezoidalMap.getSegment(nodes[node].getObject());
+                size_t cornersAtLeft = 0, cornersAtRight = 0;
+
+                for (const cg3::Point2d& corner : corners) {
+                    if (cg3::isPointAtLeft(segment, corner))
+                        cornersAtLeft++;
+                    else if (cg3::isPointAtLeft(segment.p2(), segment.p1(), corner))
+                        cornersAtRight++;
+                }
+
+                if (cornersAtLeft == 4) {
+                    node = nodes[node].getLeftChild();
+                    descending = true;
+                }
+                else if (cornersAtRight == 4) {
+                    node = nodes[node].getRightChild();
+                    descending = true;
+                }
+            }
+        }
+
+        entryGrid.setEntryNode(cell, node, nodes[node].getType() == Node::TRAPEZOID);
+    }
+}
+
+/**
+ * @brief algorithms::query returns the trapezoid index where the query point is in, following the directed acyclic graph from the entry
+ * node of the cell which contains the point, or from the root if the point is outside the grid.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param entryGrid contains the entry node of each cell.
+ * @param queryPoint is the point used to find the trapezoid which contains it.
+ * @return the trapezoid index where the query point is in.
+ */
+size_t algorithms::query(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const EntryGrid& entryGrid, const cg3::Point2d& queryPoint) {
+    const size_t cell = entryGrid.findCell(queryPoint);
+
+    return queryFrom(trapezoidalMap, directedAcyclicGraph, (cell == std::numeric_limits<size_t>::max()) ? 0 : entryGrid.getEntryNode(cell), queryPoint);
+}
+
+/**
+ * @brief algorithms::query allows many points to be located following the directed acyclic graph in packets, as ray packets in ray tracers.
+ * A packet takes up to QueryPacket::SIZE consecutive points which start from the same entry node, then each node is read once and compared
+ * with all points of the packet with geometricUtils::pointsBefore or geometricUtils::pointsAtLeft. Where the points go to different children
+ * the packet is split, and a packet left with one point follows the directed acyclic graph with queryFrom.
+ * Close points, such as the points of a raster grid, stay in the same packet down to the same trapezoid, while the packets of scattered points
+ * are split after a few nodes. The nodes are copied before they are tested, as in queryFrom.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param entryGrid contains the entry node of each cell.
+ * @param queryPoints are the points used to find the trapezoids which contain them.
+ * @param trapezoids are the trapezoid indexes where the query points are in, each one at the index of its point.
+ */
+void algorithms::query(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const EntryGrid& entryGrid, const std::vector<cg3::Point2d>& queryPoints, std::vector<size_t>& trapezoids) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<Node>& nodes = directedAcyclicGraph.getNodes();
+    std::vector<QueryPacket> packets;
+
+    trapezoids.resize(queryPoints.size());
+
+    for (size_t next = 0; next < queryPoints.size();) {
+        // the packet takes the next points while they start from the same entry node
+        const size_t cell = entryGrid.findCell(queryPoints[next]);
+        QueryPacket packet((cell == std::numeric_limits<size_t>::max()) ? 0 : entryGrid.getEntryNode(cell));
+
+        do {
+            packet.add(queryPoints[next], next);
+            next++;
+        } while (next < queryPoints.size() && !packet.isFull() && entryGrid.findCell(queryPoints[next]) == cell);
+
+        packets.push_back(packet);
+
+        while (!packets.empty()) {
+            packet = packets.back();
+            packets.pop_back();
+
+            if (packet.size == 1) {
+                trapezoids[packet.indexes[0]] = queryFrom(trapezoidalMap, directedAcyclicGraph, packet.node, cg3::Point2d(packet.x[0], packet.y[0]));
+                continue;
+            }
+
+            const uint64_t allPoints = (uint64_t(1) << packet.size) - 1;
+            Node node = nodes[packet.node];
+
+            while (node.getType() != Node::TRAPEZOID) {
+                const uint64_t leftMask = (node.getType() == Node::POINT) ?
+                            geometricUtils::pointsBefore(points[node.getObject()], packet.x, packet.y, packet.size) :
+                            geometricUtils::pointsAtLeft(trapezoidalMap.getSegment(node.getObject()), packet.x, packet.y, packet.size);
+
+                if (leftMask != allPoints && leftMask != 0) {
+                    packets.resize(packets.size() + 2);
+                    packet.split(leftMask, node.getLeftChild(), node.getRightChild(), packets[packets.size() - 2], packets.back());
+                    break;
+                }
+
+                packet.node = (leftMask == allPoints) ? node.getLeftChild() : node.getRightChild();
+                node = nodes[packet.node];
+            }
+
+            if (node.getType() == Node::TRAPEZOID)
+                for (size_t i = 0; i < packet.size; i++)
+                    trapezoids[packet.indexes[i]] = node.getObject();
+        }
+    }
+}
+
+/**
+ * @brief algorithms::build allows the partitioned trapezoidal map to be built with one thread for each slab.
+ * The slabs are balanced by the number of segment points they contain, then each segment is clipped only to the slabs of its x interval,
+ * found with two binary searches, so the partition costs O(n log k) plus the number of clipped parts. Every thread builds its own slab
+ * from its clipped segments with the randomized construction, so sorted segments do not give deep directed acyclic graphs.
+ * @param partitionedTrapezoidalMap contains the trapezoidal map and the directed acyclic graph of each slab.
+ * @param segments are the segments added to the data structures.
+ * @param slabNumber is the maximum number of slabs, fewer slabs are created when the points share too many x coordinates.
+ * @param depthFactor is the factor of the logarithm which bounds the depth of the directed acyclic graph of each slab.
+ * @param maxBuilds is the maximum number of constructions of each slab.
+ */
+void algorithms::build(PartitionedTrapezoidalMap& partitionedTrapezoidalMap, const std::vector<cg3::Segment2d>& segments, const size_t& slabNumber, const size_t& depthFactor, const size_t& maxBuilds) {
+    const cg3::BoundingBox2& boundingBox = partitionedTrapezoidalMap.getBoundingBox();
+    std::vector<double> xCoordinates;
+    std::vector<double> boundaries;
+
+    for (const cg3::Segment2d& segment : segments) {
+        xCoordinates.push_back(segment.p1().x());
+        xCoordinates.push_back(segment.p2().x());
+    }
+
+    std::sort(xCoordinates.begin(), xCoordinates.end());
+
+    // every boundary leaves the same number of points on its left, boundaries sharing the x coordinate are merged
+    for (size_t slab = 1; slab < slabNumber && !xCoordinates.empty(); slab++) {
+        const double& x = xCoordinates[slab * xCoordinates.size() / slabNumber];
+
+        if (x > boundingBox.min().x() && x < boundingBox.max().x() && (boundaries.empty() || x > boundaries.back()))
+            boundaries.push_back(x);
+    }
+
+    partitionedTrapezoidalMap.initialize(boundaries);
+
+    // the slab i lies between the boundaries i - 1 and i, so a segment can lie only in the slabs from the first boundary
+    // not on the left of its left point to the first boundary on the right of its right point
+    std::vector<std::vector<cg3::Segment2d>> slabSegments(partitionedTrapezoidalMap.getSlabNumber());
+    cg3::Segment2d clippedSegment;
+
+    for (const cg3::Segment2d& segment : segments) {
+        const double minX = std::min(segment.p1().x(), segment.p2().x());
+        const double maxX = std::max(segment.p1().x(), segment.p2().x());
+        const size_t firstSlab = static_cast<size_t>(std::lower_bound(boundaries.begin(), boundaries.end(), minX) - boundaries.begin());
+        const size_t lastSlab = static_cast<size_t>(std::upper_bound(boundaries.begin(), boundaries.end(), maxX) - boundaries.begin());
+
+        for (size_t slab = firstSlab; slab <= lastSlab; slab++) {
+            const cg3::BoundingBox2& slabBoundingBox = partitionedTrapezoidalMap.getSlabBoundingBox(slab);
+
+            if (geometricUtils::clip(segment, slabBoundingBox.min().x(), slabBoundingBox.max().x(), clippedSegment))
+                slabSegments[slab].push_back(clippedSegment);
+        }
+    }
+
+    std::vector<std::thread> threads;
+
+    for (size_t slab = 0; slab < partitionedTrapezoidalMap.getSlabNumber(); slab++)
+        threads.push_back(std::thread([&partitionedTrapezoidalMap, &slabSegments, &depthFactor, &maxBuilds, slab]() {
+            build(partitionedTrapezoidalMap.getTrapezoidalMap(slab), partitionedTrapezoidalMap.getDirectedAcyclicGraph(slab), slabSegments[slab], depthFactor, maxBuilds);
+        }));
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+/**
+ * @brief algorithms::query returns the trapezoid index where the query point is in, using the directed acyclic graph of the slab which contains it.
+ * @param partitionedTrapezoidalMap contains the trapezoidal map and the directed acyclic graph of each slab.
+ * @param queryPoint is the point used to find the trapezoid which contains it.
+ * @param slab is the index of the slab which contains the query point, the trapezoid index refers to its trapezoidal map.
+ * @return the trapezoid index where the query point is in.
+ */
+size_t algorithms::query(const PartitionedTrapezoidalMap& partitionedTrapezoidalMap, const cg3::Point2d& queryPoint, size_t& slab) {
+    slab = partitionedTrapezoidalMap.findSlab(queryPoint);
+
+    return query(partitionedTrapezoidalMap.getTrapezoidalMap(slab), partitionedTrapezoidalMap.getDirectedAcyclicGraph(slab), queryPoint);
+}
+
+/**
+ * @brief algorithms::query returns the trapezoid index where the query point is in, using two binary searches in the slab decomposition.
+ * A point on the vertical line of the left point of its trapezoid and below that point comes before it in the lexicographic order of
+ * the directed acyclic graph, so it is in the trapezoid of the slab on the left if it also comes before the right point of that one.
+ * Otherwise the point is in a trapezoid without width, which the slab decomposition does not store, and the trapezoid on its right is returned.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param slabDecomposition contains the segments of each slab and the trapezoids of their gaps.
+ * @param queryPoint is the point used to find the trapezoid which contains it.
+ * @return the trapezoid index where the query point is in.
+ */
+size_t algorithms::query(const TrapezoidalMap& trapezoidalMap, const SlabDecomposition& slabDecomposition, const cg3::Point2d& queryPoint) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const size_t slab = slabDecomposition.findSlab(queryPoint);
+    const size_t trapezoid = slabDecomposition.getTrapezoid(slab, slabDecomposition.findGap(slab, queryPoint));
+
+    // the point is in the slab, so it comes before the left point of the trapezoid only if they share the x coordinate
+    if (slab > 0 && queryPoint < points[trapezoidalMap.getTrapezoid(trapezoid).getLeftPoint()]) {
+        const size_t leftTrapezoid = slabDecomposition.getTrapezoid(slab - 1, slabDecomposition.findGap(slab - 1, queryPoint));
+
+        if (queryPoint < points[trapezoidalMap.getTrapezoid(leftTrapezoid).getRightPoint()])
+            return leftTrapezoid;
+    }
+
+    return trapezoid;
+}
+
+/**
+ * @brief algorithms::query returns the trapezoid index where the query point is in, using the version of the persistent search tree
+ * at its x coordinate to find the segment below it.
+ * As for the slab decomposition, a point which comes before the left point of its trapezoid in the lexicographic order is located
+ * again before the points of its x coordinate, and the trapezoid found there is returned if the point also comes before its right point.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param persistentSearchTree contains the versions of the sweep line and the trapezoids above each segment.
+ * @param queryPoint is the point used to find the trapezoid which contains it.
+ * @return the trapezoid index where the query point is in.
+ */
+size_t algorithms::query(const TrapezoidalMap& trapezoidalMap, const PersistentSearchTree& persistentSearchTree, const cg3::Point2d& queryPoint) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const size_t trapezoid = persistentSearchTree.findTrapezoid(persistentSearchTree.findBottomSegment(queryPoint, false), queryPoint, false);
+
+    if (queryPoint < points[trapezoidalMap.getTrapezoid(trapezoid).getLeftPoint()]) {
+        const size_t leftTrapezoid = persistentSearchTree.findTrapezoid(persistentSearchTree.findBottomSegment(queryPoint, true), queryPoint, true);
+
+        if (queryPoint < points[trapezoidalMap.getTrapezoid(leftTrapezoid).getRightPoint()])
+            return leftTrapezoid;
+    }
+
+    return trapezoid;
+}
+
+/**
+ * @brief algorithms::windowQuery returns the trapezoids and the segments which intersect the window.
+ * The trapezoid which contains the lower left corner of the window is located with the directed acyclic graph, then the trapezoids are
+ * visited through the neighbours which intersect the window. A segment which crosses the window separates trapezoids which are not
+ * neighbours, so when one of its sides has not been reached by the visit, the trapezoid on that side is located with findAdjacent,
+ * at the middle of the part of the segment inside the window (of its x interval, or of its y interval for a vertical segment).
+ * The neighbour links cannot cross a segment, so every crossing is a descent of the directed acyclic graph: the expected cost is
+ * O((1 + s) log n + k), where s is the number of crossed segments and k is the number of reported trapezoids and segments.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param window is the axis-aligned rectangle used for the query.
+ * @param trapezoids is the vector which contains the indexes of the trapezoids which intersect the window.
+ * @param segments is the vector which contains the indexes of the segments which intersect the window.
+ */
+void algorithms::windowQuery(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::BoundingBox2& window, std::vector<size_t>& trapezoids, std::vector<size_t>& segments) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const cg3::BoundingBox2 clippedWindow(window.min().max(points[0]), window.max().min(points[1]));
+
+    // the window does not intersect the bounding box of the trapezoidal map
+    if (clippedWindow.min().x() > clippedWindow.max().x() || clippedWindow.min().y() > clippedWindow.max().y())
+        return;
+
+    // sides of the segments reached by the visit (1 if the trapezoid above was reached, 2 if the trapezoid below was reached)
+    FlatHashMap<size_t, unsigned char, IndexHash> reachedSides;
+    FlatHashMap<size_t, bool, IndexHash> visited;
+    std::vector<size_t> toVisit = {query(trapezoidalMap, directedAcyclicGraph, clippedWindow.min())};
+    size_t nextSegment = 0;
+
+    visited.insert({toVisit.back(), true});
+
+    while (!toVisit.empty()) {
+        while (!toVisit.empty()) {
+            const size_t id = toVisit.back();
+            const Trapezoid& trapezoid = trapezoidalMap.getTrapezoid(id);
+            toVisit.pop_back();
+
+            trapezoids.push_back(id);
+
+            // store the segments which bound the trapezoid the first time one of their sides is reached,
+            // the trapezoid is above its bottom segment and below its top segment
+            if (trapezoid.getBottomSegment() != std::numeric_limits<size_t>::max()) {
+                unsigned char& bottomSides = reachedSides.insert({trapezoid.getBottomSegment(), 0}).first->second;
+
+                if (bottomSides == 0)
+                    segments.push_back(trapezoid.getBottomSegment());
+
+                bottomSides |= 1;
+            }
+
+            if (trapezoid.getTopSegment() != std::numeric_limits<size_t>::max()) {
+                unsigned char& topSides = reachedSides.insert({trapezoid.getTopSegment(), 0}).first->second;
+
+                if (topSides == 0)
+                    segments.push_back(trapezoid.getTopSegment());
+
+                topSides |= 2;
+            }
+
+            // visit the neighbours which intersect the window
+            for (const size_t& neighbour : {trapezoid.getUpperLeftNeighbour(), trapezoid.getLowerLeftNeighbour(), trapezoid.getUpperRightNeighbour(), trapezoid.getLowerRightNeighbour()})
+                if (neighbour != std::numeric_limits<size_t>::max() && visited.find(neighbour) == visited.end()
+                        && geometricUtils::intersects(trapezoidalMap.getTopSegment(neighbour), trapezoidalMap.getBottomSegment(neighbour), points[trapezoidalMap.getTrapezoid(neighbour).getLeftPoint()], points[trapezoidalMap.getTrapezoid(neighbour).getRightPoint()], clippedWindow)) {
+                    visited.insert({neighbour, true});
+                    toVisit.push_back(neighbour);
+                }
+        }
+
+        // cross the first segment which intersects the window and has a side not reached yet
+        for (; nextSegment < segments.size() && toVisit.empty(); nextSegment++) {
+            const unsigned char sides = reachedSides.find(segments[nextSegment])->second;
+            const cg3::Segment2d& segment = trapezoidalMap.getSegment(segments[nextSegment]);
+            size_t adjacent = std::numeric_limits<size_t>::max();
+            double minX, maxX;
+
+            if (sides != 3 && geometricUtils::clip(segment, clippedWindow, minX, maxX)) {
+                if (minX < maxX)
+                    adjacent = findAdjacent(trapezoidalMap, directedAcyclicGraph, segments[nextSegment], (minX + maxX) / 2, sides == 2);
+                else if (segment.p1().x() == segment.p2().x()) {
+                    // the sides of a vertical segment are the ones of the sheared plane, so its middle point inside the window is used
+                    const double minY = std::max(segment.p1().y(), clippedWindow.min().y());
+                    const double maxY = std::min(segment.p2().y(), clippedWindow.max().y());
+
+                    if (minY < maxY)
+                        adjacent = findAdjacent(trapezoidalMap, directedAcyclicGraph, segments[nextSegment], cg3::Point2d(segment.p1().x(), (minY + maxY) / 2), sides == 2);
+                }
+            }
+
+            if (adjacent != std::numeric_limits<size_t>::max() && visited.insert({adjacent, true}).second)
+                toVisit.push_back(adjacent);
+        }
+    }
+
+    // keep only the segments which intersect the window
+    segments.erase(std::remove_if(segments.begin(), segments.end(), [&](const size_t& segment) {
+        double minX, maxX;
+        return !geometricUtils::clip(trapezoidalMap.getSegment(segment), clippedWindow, minX, maxX);
+    }), segments.end());
 }
 
 /**
@@ -57,21 +601,72 @@ size_t algorithms::query(const TrapezoidalMap& trapezoidalMap, const DirectedAcy
  * @return the trapezoid index where the left point of the segment is in.
  */
 size_t algorithms::find(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Segment2d& segment) {
-    const std::vector<cg3::Point2d>& points = trapezoidalMap.getPoints();
-    const std::vector<Node>& nodes = directedAcyclicGraph.getNodes();
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<Node>& nodes = directedAcyclicGraph.getNodes();
     const cg3::Point2d& queryPoint = segment.p1();
-    const double& slope = geometricUtils::slope(segment);
     size_t id = 0;
 
     while (nodes[id].getType() != Node::TRAPEZOID)
         if (nodes[id].getType() == Node::POINT)
-            if (points[nodes[id].getObject()].x() > queryPoint.x())
+            if (points[nodes[id].getObject()] > queryPoint)
                 id = nodes[id].getLeftChild();
             else
                 id = nodes[id].getRightChild();
         else
             if (trapezoidalMap.getSegment(nodes[id].getObject()).p1() == queryPoint)
-                if (slope > geometricUtils::slope(trapezoidalMap.getSegment(nodes[id].getObject())))
+                // the segments share the left point, so the right point decides (it also works for vertical segments)
+                if (cg3::isPointAtLeft(trapezoidalMap.getSegment(nodes[id].getObject()), segment.p2()))
+                    id = nodes[id].getLeftChild();
+                else
+                    id = nodes[id].getRightChild();
+            else
+                if (cg3::isPointAtLeft(trapezoidalMap.getSegment(nodes[id].getObject()), queryPoint))
+                    id = nodes[id].getLeftChild();
+                else
+                    id = nodes[id].getRightChild();
+
+    return nodes[id].getObject();
+}
+
+/**
+ * @brief algorithms::findAdjacent returns the trapezoid index which is adjacent to the segment at the x coordinate, using the directed acyclic graph and the trapezoidal map.
+ * The descent uses the point of the segment at the x coordinate, so the x coordinate must be strictly between the segment points.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param segment is the index of the segment.
+ * @param x is the x coordinate where the adjacent trapezoid is searched.
+ * @param above is a boolean variable which is true when the trapezoid above the segment is searched, otherwise the one below is searched.
+ * @return the trapezoid index which is adjacent to the segment at the x coordinate.
+ */
+size_t algorithms::findAdjacent(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& segment, const double& x, const bool& above) {
+    return findAdjacent(trapezoidalMap, directedAcyclicGraph, segment, geometricUtils::intersection(trapezoidalMap.getSegment(segment), x), above);
+}
+
+/**
+ * @brief algorithms::findAdjacent returns the trapezoid index which is adjacent to the segment at the point, using the directed acyclic graph and the trapezoidal map.
+ * Points are compared lexicographically, so it also works for a point of a vertical segment, whose trapezoid above is the one on its left.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param segment is the index of the segment.
+ * @param segmentPoint is the point of the segment where the adjacent trapezoid is searched, strictly between the segment points.
+ * @param above is a boolean variable which is true when the trapezoid above the segment is searched, otherwise the one below is searched.
+ * @return the trapezoid index which is adjacent to the segment at the point.
+ */
+size_t algorithms::findAdjacent(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& segment, const cg3::Point2d& segmentPoint, const bool& above) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<Node>& nodes = directedAcyclicGraph.getNodes();
+    const cg3::Point2d& queryPoint = segmentPoint;
+    size_t id = 0;
+
+    while (nodes[id].getType() != Node::TRAPEZOID)
+        if (nodes[id].getType() == Node::POINT)
+            if (points[nodes[id].getObject()] > queryPoint)
+                id = nodes[id].getLeftChild();
+            else
+                id = nodes[id].getRightChild();
+        else
+            if (nodes[id].getObject() == segment)
+                if (above)
                     id = nodes[id].getLeftChild();
                 else
                     id = nodes[id].getRightChild();
@@ -92,8 +687,8 @@ size_t algorithms::find(const TrapezoidalMap& trapezoidalMap, const DirectedAcyc
  * @param intersectedTrapezoids is the vector which contains the trapezoids which are intersected by the segment.
  */
 void algorithms::followSegment(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Segment2d& segment, std::vector<size_t>& intersectedTrapezoids) {
-    const std::vector<cg3::Point2d>& points = trapezoidalMap.getPoints();
-    const std::vector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
     bool follow = true;
 
     size_t id = find(trapezoidalMap, directedAcyclicGraph, segment);
@@ -101,7 +696,7 @@ void algorithms::followSegment(const TrapezoidalMap& trapezoidalMap, const Direc
     while (follow) {
         intersectedTrapezoids.push_back(id);
 
-        if (segment.p2().x() <= points[trapezoids[id].getRightPoint()].x())
+        if (segment.p2() <= points[trapezoids[id].getRightPoint()])
             follow = false;
         else {
             if (cg3::isPointAtLeft(segment, points[trapezoids[id].getRightPoint()]))
@@ -119,23 +714,29 @@ void algorithms::followSegment(const TrapezoidalMap& trapezoidalMap, const Direc
  * @brief algorithms::update allows the trapezoidal map and the directed acyclic graph to be updated when a segment intersects a trapezoid.
  * @param trapezoidalMap contains all points, segments, and trapezoids.
  * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param constructionContext contains the scratch vectors of the construction.
  * @param segment is the segment which intersects the trapezoid.
  * @param intersectedTrapezoid is the trapezoid intersected by the segment.
  */
-void algorithms::update(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const size_t& segment, const size_t& intersectedTrapezoid) {
-    const std::vector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
+void algorithms::update(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, ConstructionContext& constructionContext, const size_t& segment, const size_t& intersectedTrapezoid) {
+    const ChunkedVector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
     const TrapezoidalMap::IndexedSegment2d& indexedSegment = trapezoidalMap.getIndexedSegment(segment);
+    std::vector<size_t>& newTrapezoids = constructionContext.newTrapezoids;
+    std::vector<size_t>& newTrapezoidNodes = constructionContext.newTrapezoidNodes;
+    const bool leftPointUnshared = indexedSegment.first != trapezoids[intersectedTrapezoid].getLeftPoint();
 
     // indexes of the new trapezoids (minimum 3)
-    std::vector<size_t> newTrapezoids = {intersectedTrapezoid, trapezoids.size(), trapezoids.size() + 1};
-    std::vector<size_t> newTrapezoidNodes;
-    const bool leftPointUnshared = indexedSegment.first != trapezoids[intersectedTrapezoid].getLeftPoint();
+    newTrapezoids.clear();
+    newTrapezoids.push_back(intersectedTrapezoid);
+    newTrapezoids.push_back(trapezoids.size());
+    newTrapezoids.push_back(trapezoids.size() + 1);
+    newTrapezoidNodes.clear();
 
     // add a fourth index for a new trapezoid if the segment points are new
     if (leftPointUnshared && indexedSegment.second != trapezoids[intersectedTrapezoid].getRightPoint())
         newTrapezoids.push_back(trapezoids.size() + 2);
 
-    directedAcyclicGraph.update(trapezoids[intersectedTrapezoid].getNode(), indexedSegment.first, indexedSegment.second, segment, newTrapezoids, newTrapezoidNodes, leftPointUnshared);
+    directedAcyclicGraph.update(trapezoids[intersectedTrapezoid].getNode(), indexedSegment.first, indexedSegment.second, segment, newTrapezoids, newTrapezoidNodes, leftPointUnshared, constructionContext);
     trapezoidalMap.update(intersectedTrapezoid, indexedSegment.first, indexedSegment.second, segment, newTrapezoids, newTrapezoidNodes, leftPointUnshared);
 }
 
@@ -143,12 +744,13 @@ void algorithms::update(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& di
  * @brief algorithms::update allows the trapezoidal map and the directed acyclic graph to be updated when a segment intersects more trapezoids.
  * @param trapezoidalMap contains all points, segments, and trapezoids.
  * @param directedAcyclicGraph contains all point, segment, and trapezoid nodes.
+ * @param constructionContext contains the scratch vectors of the construction.
  * @param segment is the segment which intersects the trapezoids.
  * @param intersectedTrapezoids is the vector of trapezoids intersected by the segment.
  */
-void algorithms::update(TrapezoidalMap &trapezoidalMap, DirectedAcyclicGraph &directedAcyclicGraph, const size_t& segment, const std::vector<size_t>& intersectedTrapezoids) {
-    const std::vector<cg3::Point2d>& points = trapezoidalMap.getPoints();
-    const std::vector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
+void algorithms::update(TrapezoidalMap &trapezoidalMap, DirectedAcyclicGraph &directedAcyclicGraph, ConstructionContext& constructionContext, const size_t& segment, const std::vector<size_t>& intersectedTrapezoids) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
     const TrapezoidalMap::IndexedSegment2d& indexedSegment = trapezoidalMap.getIndexedSegment(segment);
 
     // leftPoint is null if the point already exists, else it is the segment's left point.
@@ -157,10 +759,20 @@ void algorithms::update(TrapezoidalMap &trapezoidalMap, DirectedAcyclicGraph &di
     // rightPoint is null if the point already exists, else it is the segment's right point.
     const size_t& rightPoint = (trapezoids[intersectedTrapezoids.back()].getRightPoint() == indexedSegment.second) ? std::numeric_limits<size_t>::max() : indexedSegment.second;
 
-    std::vector<size_t> newTrapezoids = {trapezoids.size()};
-    std::vector<size_t> newTrapezoidNodes;
-    std::vector<size_t> nodesToDelete, leftChildren, rightChildren;
-    std::vector<bool> above;
+    std::vector<size_t>& newTrapezoids = constructionContext.newTrapezoids;
+    std::vector<size_t>& newTrapezoidNodes = constructionContext.newTrapezoidNodes;
+    std::vector<size_t>& nodesToDelete = constructionContext.nodesToDelete;
+    std::vector<size_t>& leftChildren = constructionContext.leftChildren;
+    std::vector<size_t>& rightChildren = constructionContext.rightChildren;
+    std::vector<bool>& above = constructionContext.above;
+
+    newTrapezoids.clear();
+    newTrapezoids.push_back(trapezoids.size());
+    newTrapezoidNodes.clear();
+    nodesToDelete.clear();
+    leftChildren.clear();
+    rightChildren.clear();
+    above.clear();
 
     // if leftPoint is not null, the first trapezoid intersected by the segment is divided into 3 trapezoids.
     if (leftPoint == indexedSegment.first)
@@ -194,6 +806,6 @@ void algorithms::update(TrapezoidalMap &trapezoidalMap, DirectedAcyclicGraph &di
     while (rightChildren.size() < nodesToDelete.size())
         rightChildren.push_back(std::numeric_limits<size_t>::max());
 
-    directedAcyclicGraph.update(nodesToDelete, leftPoint, rightPoint, segment, newTrapezoids, newTrapezoidNodes, leftChildren, rightChildren);
-    trapezoidalMap.update(intersectedTrapezoids, leftPoint, rightPoint, segment, newTrapezoids, newTrapezoidNodes, above);
+    directedAcyclicGraph.update(nodesToDelete, leftPoint, rightPoint, segment, newTrapezoids, newTrapezoidNodes, leftChildren, rightChildren, constructionContext);
+    trapezoidalMap.update(intersectedTrapezoids, leftPoint, rightPoint, segment, newTrapezoids, newTrapezoidNodes, above, constructionContext);
 }
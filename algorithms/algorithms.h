@@ -3,16 +3,47 @@
 
 #include "data_structures/trapezoidalmap.h"
 #include "data_structures/directed_acyclic_graph.h"
+#include "data_structures/versioned_trapezoidalmap.h"
+#include "data_structures/partitioned_trapezoidalmap.h"
+#include "data_structures/slab_decomposition.h"
+#include "data_structures/persistent_search_tree.h"
+#include "data_structures/entry_grid.h"
+#include "data_structures/construction_context.h"
+#include "data_structures/query_packet.h"
+
+#include <cg3/geometry/bounding_box2.h>
+
+#include <functional>
 
 namespace algorithms {
     void add(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Segment2d& segment);
+    void add(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, ConstructionContext& constructionContext, const cg3::Segment2d& segment);
+    void add(VersionedTrapezoidalMap& versionedTrapezoidalMap, const std::vector<cg3::Segment2d>& segments);
+    size_t build(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const std::vector<cg3::Segment2d>& segments, const size_t& depthFactor, const size_t& maxBuilds);
+    size_t build(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const std::vector<cg3::Segment2d>& segments, const size_t& depthFactor, const size_t& maxBuilds, const std::function<bool()>& segmentAdded);
     size_t query(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Point2d& queryPoint);
+    size_t queryFrom(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& startNode, const cg3::Point2d& queryPoint);
+
+    void add(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, EntryGrid& entryGrid, ConstructionContext& constructionContext, const cg3::Segment2d& segment);
+    void build(EntryGrid& entryGrid, const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& resolution);
+    void refine(EntryGrid& entryGrid, const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const std::vector<size_t>& cells);
+    size_t query(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const EntryGrid& entryGrid, const cg3::Point2d& queryPoint);
+    void query(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const EntryGrid& entryGrid, const std::vector<cg3::Point2d>& queryPoints, std::vector<size_t>& trapezoids);
+
+    void build(PartitionedTrapezoidalMap& partitionedTrapezoidalMap, const std::vector<cg3::Segment2d>& segments, const size_t& slabNumber, const size_t& depthFactor, const size_t& maxBuilds);
+    size_t query(const PartitionedTrapezoidalMap& partitionedTrapezoidalMap, const cg3::Point2d& queryPoint, size_t& slab);
+    size_t query(const TrapezoidalMap& trapezoidalMap, const SlabDecomposition& slabDecomposition, const cg3::Point2d& queryPoint);
+    size_t query(const TrapezoidalMap& trapezoidalMap, const PersistentSearchTree& persistentSearchTree, const cg3::Point2d& queryPoint);
+
+    void windowQuery(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::BoundingBox2& window, std::vector<size_t>& trapezoids, std::vector<size_t>& segments);
 
     size_t find(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Segment2d& segment);
+    size_t findAdjacent(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& segment, const double& x, const bool& above);
+    size_t findAdjacent(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& segment, const cg3::Point2d& segmentPoint, const bool& above);
     void followSegment(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const cg3::Segment2d& segment, std::vector<size_t>& intersectedTrapezoids);
 
-    void update(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, const size_t& segment, const size_t& intersectedTrapezoid);
-    void update(TrapezoidalMap &trapezoidalMap, DirectedAcyclicGraph &directedAcyclicGraph, const size_t& segment, const std::vector<size_t>& intersectedTrapezoids);
+    void update(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph, ConstructionContext& constructionContext, const size_t& segment, const size_t& intersectedTrapezoid);
+    void update(TrapezoidalMap &trapezoidalMap, DirectedAcyclicGraph &directedAcyclicGraph, ConstructionContext& constructionContext, const size_t& segment, const std::vector<size_t>& intersectedTrapezoids);
 }
 
 #endif // ALGORITHMS_H
@@ -0,0 +1,393 @@
+#ifndef CHUNKED_VECTOR_H
+#define CHUNKED_VECTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+/**
+ * @brief The ChunkedVector class allows to store elements in fixed-size chunks, so elements are never relocated when new ones are added.
+ * Copies of a chunked vector share their chunks: a shared chunk is copied only when one of its elements is modified (copy-on-write),
+ * so a copy costs one pointer per chunk and unchanged elements are stored once.
+ * The table of chunks is replaced atomically when it grows and the old tables are kept until clear, so one writer can add elements
+ * while other threads read the elements which have been published to them (chunks shared with copies must not be written meanwhile).
+ * Chunks and tables are allocated from a memory resource. As for std::pmr containers, a copy allocates from the default resource
+ * and an assignment keeps the resource of the target, while the shared chunks stay in the resource which allocated them,
+ * so it must outlive every copy.
+ */
+template <class T, size_t ChunkBits = 8>
+class ChunkedVector {
+
+public:
+    static const size_t CHUNK_SIZE = size_t(1) << ChunkBits;
+
+    class const_iterator {
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const_iterator(const ChunkedVector* chunkedVector, const size_t& id) : chunkedVector(chunkedVector), id(id) {}
+
+        const T& operator*() const { return (*chunkedVector)[id]; }
+        const T* operator->() const { return &(*chunkedVector)[id]; }
+        const_iterator& operator++() { id++; return *this; }
+        bool operator==(const const_iterator& other) const { return id == other.id; }
+        bool operator!=(const const_iterator& other) const { return id != other.id; }
+
+    private:
+        const ChunkedVector* chunkedVector;
+        size_t id;
+
+    };
+
+    ChunkedVector();
+    explicit ChunkedVector(std::pmr::memory_resource* memoryResource);
+    ChunkedVector(const ChunkedVector& other);
+
+    ChunkedVector& operator=(const ChunkedVector& other);
+
+    size_t size() const;
+    bool empty() const;
+    size_t memoryUsage() const;
+    std::pmr::memory_resource* getMemoryResource() const;
+
+    const T& operator[](const size_t& id) const;
+    T& operator[](const size_t& id);
+
+    const T& front() const;
+    const T& back() const;
+
+    void push_back(const T& value);
+    void clear();
+    void swap(ChunkedVector& other);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    /**
+     * @brief The Chunk class stores up to CHUNK_SIZE elements in place, without default-constructing them.
+     */
+    class Chunk {
+
+    public:
+        Chunk() {}
+        Chunk(const Chunk& other) { for (; size < other.size; size++) new (data() + size) T(other.data()[size]); }
+        ~Chunk() { for (size_t i = 0; i < size; i++) data()[i].~T(); }
+        Chunk& operator=(const Chunk& other) = delete;
+
+        T* data() { return reinterpret_cast<T*>(storage); }
+        const T* data() const { return reinterpret_cast<const T*>(storage); }
+
+        size_t size = 0;
+
+    private:
+        alignas(T) unsigned char storage[CHUNK_SIZE * sizeof(T)];
+
+    };
+
+    Chunk& detach(const size_t& chunk);
+    void setChunk(const size_t& chunk, const std::shared_ptr<Chunk>& pointer);
+    void rebuildTable();
+
+    std::shared_ptr<Chunk> allocateChunk() const;
+    std::shared_ptr<Chunk> allocateChunk(const Chunk& other) const;
+
+    std::pmr::memory_resource* memoryResource;
+
+    std::pmr::vector<std::shared_ptr<Chunk>> chunks;
+
+    std::pmr::vector<std::pmr::vector<Chunk*>> tables;
+    std::atomic<Chunk**> table;
+    size_t tableCapacity;
+
+    size_t elementNumber;
+
+};
+
+/**
+ * @brief ChunkedVector::ChunkedVector is the constructor of the class which creates an empty chunked vector using the default memory resource.
+ */
+template <class T, size_t ChunkBits>
+ChunkedVector<T, ChunkBits>::ChunkedVector() : ChunkedVector(std::pmr::get_default_resource()) {
+
+}
+
+/**
+ * @brief ChunkedVector::ChunkedVector is the constructor of the class which creates an empty chunked vector using the given memory resource.
+ * @param memoryResource is the memory resource which allocates chunks and tables.
+ */
+template <class T, size_t ChunkBits>
+ChunkedVector<T, ChunkBits>::ChunkedVector(std::pmr::memory_resource* memoryResource) :
+    memoryResource(memoryResource), chunks(memoryResource), tables(memoryResource), table(nullptr), tableCapacity(0), elementNumber(0) {
+
+}
+
+/**
+ * @brief ChunkedVector::ChunkedVector is the copy constructor of the class, the chunks are shared with the other chunked vector
+ * and the new ones are allocated from the default memory resource.
+ * @param other is the chunked vector to be copied.
+ */
+template <class T, size_t ChunkBits>
+ChunkedVector<T, ChunkBits>::ChunkedVector(const ChunkedVector& other) :
+    memoryResource(std::pmr::get_default_resource()), chunks(other.chunks.begin(), other.chunks.end(), memoryResource), tables(memoryResource),
+    table(nullptr), tableCapacity(0), elementNumber(other.elementNumber) {
+    rebuildTable();
+}
+
+/**
+ * @brief ChunkedVector::operator = allows the chunks of the other chunked vector to be shared.
+ * @param other is the chunked vector to be copied.
+ * @return this chunked vector.
+ */
+template <class T, size_t ChunkBits>
+ChunkedVector<T, ChunkBits>& ChunkedVector<T, ChunkBits>::operator=(const ChunkedVector& other) {
+    if (this != &other) {
+        chunks.assign(other.chunks.begin(), other.chunks.end());
+        elementNumber = other.elementNumber;
+        rebuildTable();
+    }
+
+    return *this;
+}
+
+/**
+ * @brief ChunkedVector::size returns the number of stored elements.
+ * @return the number of stored elements.
+ */
+template <class T, size_t ChunkBits>
+size_t ChunkedVector<T, ChunkBits>::size() const {
+    return elementNumber;
+}
+
+/**
+ * @brief ChunkedVector::empty returns whether no element is stored.
+ * @return true if no element is stored, otherwise false.
+ */
+template <class T, size_t ChunkBits>
+bool ChunkedVector<T, ChunkBits>::empty() const {
+    return elementNumber == 0;
+}
+
+/**
+ * @brief ChunkedVector::memoryUsage returns the number of bytes allocated by the chunked vector, counting the shared chunks too.
+ * Each chunk is allocated with the control block of its shared pointer (a virtual table pointer, two counters and the allocator).
+ * @return the number of bytes allocated by the chunked vector.
+ */
+template <class T, size_t ChunkBits>
+size_t ChunkedVector<T, ChunkBits>::memoryUsage() const {
+    size_t bytes = chunks.capacity() * sizeof(std::shared_ptr<Chunk>) + chunks.size() * (sizeof(Chunk) + 3 * sizeof(void*)) +
+                   tables.capacity() * sizeof(std::pmr::vector<Chunk*>);
+
+    for (size_t i = 0; i < tables.size(); i++)
+        bytes += tables[i].capacity() * sizeof(Chunk*);
+
+    return bytes;
+}
+
+/**
+ * @brief ChunkedVector::getMemoryResource returns the memory resource which allocates the new chunks and tables.
+ * @return the memory resource of the chunked vector.
+ */
+template <class T, size_t ChunkBits>
+std::pmr::memory_resource* ChunkedVector<T, ChunkBits>::getMemoryResource() const {
+    return memoryResource;
+}
+
+/**
+ * @brief ChunkedVector::operator [] returns the element stored in the position "id".
+ * @param id is the element position.
+ * @return the element stored in the position "id".
+ */
+template <class T, size_t ChunkBits>
+const T& ChunkedVector<T, ChunkBits>::operator[](const size_t& id) const {
+    return table.load(std::memory_order_acquire)[id >> ChunkBits]->data()[id & (CHUNK_SIZE - 1)];
+}
+
+/**
+ * @brief ChunkedVector::operator [] returns the element stored in the position "id", copying its chunk first if it is shared with another chunked vector.
+ * @param id is the element position.
+ * @return the element stored in the position "id".
+ */
+template <class T, size_t ChunkBits>
+T& ChunkedVector<T, ChunkBits>::operator[](const size_t& id) {
+    return detach(id >> ChunkBits).data()[id & (CHUNK_SIZE - 1)];
+}
+
+/**
+ * @brief ChunkedVector::front returns the first element.
+ * @return the first element.
+ */
+template <class T, size_t ChunkBits>
+const T& ChunkedVector<T, ChunkBits>::front() const {
+    return (*this)[0];
+}
+
+/**
+ * @brief ChunkedVector::back returns the last element.
+ * @return the last element.
+ */
+template <class T, size_t ChunkBits>
+const T& ChunkedVector<T, ChunkBits>::back() const {
+    return (*this)[elementNumber - 1];
+}
+
+/**
+ * @brief ChunkedVector::push_back allows to store a new element after the last one, allocating a new chunk if the last one is full.
+ * @param value is the element to be stored.
+ */
+template <class T, size_t ChunkBits>
+void ChunkedVector<T, ChunkBits>::push_back(const T& value) {
+    if ((elementNumber & (CHUNK_SIZE - 1)) == 0)
+        setChunk(chunks.size(), allocateChunk());
+
+    Chunk& chunk = detach(elementNumber >> ChunkBits);
+    new (chunk.data() + chunk.size) T(value);
+    chunk.size++;
+    elementNumber++;
+}
+
+/**
+ * @brief ChunkedVector::clear allows to delete all elements, the shared chunks and the old tables are released.
+ * No other thread may read the chunked vector meanwhile.
+ */
+template <class T, size_t ChunkBits>
+void ChunkedVector<T, ChunkBits>::clear() {
+    chunks.clear();
+    elementNumber = 0;
+    rebuildTable();
+}
+
+/**
+ * @brief ChunkedVector::swap allows the elements of two chunked vectors to be exchanged. When they use the same memory resource their chunks
+ * and tables are exchanged without copying, otherwise each one shares the chunks of the other and rebuilds its table, as an assignment does.
+ * No other thread may read the chunked vectors meanwhile.
+ * @param other is the chunked vector to be exchanged with this one.
+ */
+template <class T, size_t ChunkBits>
+void ChunkedVector<T, ChunkBits>::swap(ChunkedVector& other) {
+    if (memoryResource != other.memoryResource) {
+        ChunkedVector copy(other);
+        other = *this;
+        *this = copy;
+        return;
+    }
+
+    chunks.swap(other.chunks);
+    tables.swap(other.tables);
+    table.store(other.table.exchange(table.load()));
+    std::swap(tableCapacity, other.tableCapacity);
+    std::swap(elementNumber, other.elementNumber);
+}
+
+/**
+ * @brief ChunkedVector::begin returns the iterator to the first element.
+ * @return the iterator to the first element.
+ */
+template <class T, size_t ChunkBits>
+typename ChunkedVector<T, ChunkBits>::const_iterator ChunkedVector<T, ChunkBits>::begin() const {
+    return const_iterator(this, 0);
+}
+
+/**
+ * @brief ChunkedVector::end returns the iterator after the last element.
+ * @return the iterator after the last element.
+ */
+template <class T, size_t ChunkBits>
+typename ChunkedVector<T, ChunkBits>::const_iterator ChunkedVector<T, ChunkBits>::end() const {
+    return const_iterator(this, elementNumber);
+}
+
+/**
+ * @brief ChunkedVector::detach returns the chunk in the position "chunk", after replacing it with a private copy if it is shared with another chunked vector.
+ * A count of one cannot grow concurrently, since no other chunked vector references the chunk; the fence orders the release of the chunk
+ * by other threads before the following writes.
+ * @param chunk is the chunk position.
+ * @return the chunk in the position "chunk", which is owned only by this chunked vector.
+ */
+template <class T, size_t ChunkBits>
+typename ChunkedVector<T, ChunkBits>::Chunk& ChunkedVector<T, ChunkBits>::detach(const size_t& chunk) {
+    if (chunks[chunk].use_count() != 1)
+        setChunk(chunk, allocateChunk(*chunks[chunk]));
+    else
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+    return *chunks[chunk];
+}
+
+/**
+ * @brief ChunkedVector::allocateChunk returns a new empty chunk, allocated with its control block from the memory resource.
+ * @return the new chunk.
+ */
+template <class T, size_t ChunkBits>
+std::shared_ptr<typename ChunkedVector<T, ChunkBits>::Chunk> ChunkedVector<T, ChunkBits>::allocateChunk() const {
+    return std::allocate_shared<Chunk>(std::pmr::polymorphic_allocator<Chunk>(memoryResource));
+}
+
+/**
+ * @brief ChunkedVector::allocateChunk returns a copy of the chunk, allocated with its control block from the memory resource.
+ * @param other is the chunk to be copied.
+ * @return the new chunk.
+ */
+template <class T, size_t ChunkBits>
+std::shared_ptr<typename ChunkedVector<T, ChunkBits>::Chunk> ChunkedVector<T, ChunkBits>::allocateChunk(const Chunk& other) const {
+    return std::allocate_shared<Chunk>(std::pmr::polymorphic_allocator<Chunk>(memoryResource), other);
+}
+
+/**
+ * @brief ChunkedVector::setChunk allows a chunk to be stored in the position "chunk", which is an existing one or the next one.
+ * When the table of chunks is full, a table with double capacity is filled and then published, while the old one is kept
+ * for the threads which are still reading it (moving a table keeps its elements in place, since all tables share the memory resource).
+ * @param chunk is the chunk position.
+ * @param pointer is the chunk to be stored.
+ */
+template <class T, size_t ChunkBits>
+void ChunkedVector<T, ChunkBits>::setChunk(const size_t& chunk, const std::shared_ptr<Chunk>& pointer) {
+    if (chunk == chunks.size())
+        chunks.push_back(pointer);
+    else
+        chunks[chunk] = pointer;
+
+    if (chunk < tableCapacity) {
+        table.load(std::memory_order_relaxed)[chunk] = pointer.get();
+    }
+    else {
+        const size_t capacity = std::max(2 * tableCapacity, size_t(1));
+        tables.emplace_back(capacity);
+
+        for (size_t i = 0; i < chunks.size(); i++)
+            tables.back()[i] = chunks[i].get();
+
+        tableCapacity = capacity;
+        table.store(tables.back().data(), std::memory_order_release);
+    }
+}
+
+/**
+ * @brief ChunkedVector::rebuildTable allows the table of chunks to be rebuilt from the stored chunks, releasing the old tables.
+ */
+template <class T, size_t ChunkBits>
+void ChunkedVector<T, ChunkBits>::rebuildTable() {
+    tables.clear();
+    tableCapacity = chunks.size();
+
+    if (tableCapacity > 0) {
+        tables.emplace_back(tableCapacity);
+
+        for (size_t i = 0; i < chunks.size(); i++)
+            tables.back()[i] = chunks[i].get();
+    }
+
+    table.store(tables.empty() ? nullptr : tables.back().data(), std::memory_order_release);
+}
+
+#endif // CHUNKED_VECTOR_H
@@ -0,0 +1,20 @@
+#include "construction_context.h"
+
+/**
+ * @brief ConstructionContext::ConstructionContext is the constructor of the class which creates empty scratch vectors.
+ */
+ConstructionContext::ConstructionContext() {
+
+}
+
+/**
+ * @brief ConstructionContext::memoryUsage returns the number of bytes allocated by the scratch vectors.
+ * @return the number of bytes allocated by the scratch vectors.
+ */
+size_t ConstructionContext::memoryUsage() const {
+    size_t bytes = (intersectedTrapezoids.capacity() + splitNodes.capacity() + newTrapezoids.capacity() + newTrapezoidNodes.capacity() +
+                    nodesToDelete.capacity() + leftChildren.capacity() + rightChildren.capacity() + nodesToReplace.capacity() +
+                    upperLeftNeighboursAbove.capacity() + lowerLeftNeighboursBelow.capacity() + leafCells.capacity()) * sizeof(size_t);
+
+    return bytes + above.capacity() / 8 + replacingNodes.capacity() * sizeof(Node);
+}
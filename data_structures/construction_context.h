@@ -0,0 +1,41 @@
+#ifndef CONSTRUCTION_CONTEXT_H
+#define CONSTRUCTION_CONTEXT_H
+
+#include <vector>
+#include "node.h"
+
+/**
+ * @brief The ConstructionContext class stores the scratch vectors of the incremental construction, which are passed to the algorithms and
+ * to the updates of the trapezoidal map and of the directed acyclic graph. Each step clears the vectors it uses, which keeps their capacity,
+ * so once they have grown to the largest update the insertion of a segment does not allocate them again.
+ * One context must be used by one construction at a time.
+ */
+class ConstructionContext {
+
+public:
+    ConstructionContext();
+
+    size_t memoryUsage() const;
+
+    // algorithms::add and algorithms::update
+    std::vector<size_t> intersectedTrapezoids;
+    std::vector<size_t> splitNodes;
+    std::vector<size_t> newTrapezoids;
+    std::vector<size_t> newTrapezoidNodes;
+    std::vector<size_t> nodesToDelete;
+    std::vector<size_t> leftChildren;
+    std::vector<size_t> rightChildren;
+    std::vector<bool> above;
+    std::vector<size_t> leafCells;
+
+    // DirectedAcyclicGraph::update
+    std::vector<size_t> nodesToReplace;
+    std::vector<Node> replacingNodes;
+
+    // TrapezoidalMap::update
+    std::vector<size_t> upperLeftNeighboursAbove;
+    std::vector<size_t> lowerLeftNeighboursBelow;
+
+};
+
+#endif // CONSTRUCTION_CONTEXT_H
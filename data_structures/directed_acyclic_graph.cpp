@@ -1,9 +1,21 @@
 #include "directed_acyclic_graph.h"
 
+#include <algorithm>
+
 /**
- * @brief DirectedAcyclicGraph::DirectedAcyclicGraph is the constructor of the class which initializes the vector "nodes".
+ * @brief DirectedAcyclicGraph::DirectedAcyclicGraph is the constructor of the class which initializes the vector "nodes" using the default memory resource.
  */
-DirectedAcyclicGraph::DirectedAcyclicGraph() {
+DirectedAcyclicGraph::DirectedAcyclicGraph() :
+    DirectedAcyclicGraph(std::pmr::get_default_resource()) {
+
+}
+
+/**
+ * @brief DirectedAcyclicGraph::DirectedAcyclicGraph is the constructor of the class which initializes the vector "nodes" using the given memory resource.
+ * @param memoryResource is the memory resource which allocates nodes and depths.
+ */
+DirectedAcyclicGraph::DirectedAcyclicGraph(std::pmr::memory_resource* memoryResource) :
+    nodes(memoryResource), depths(memoryResource), maxDepth(0) {
     initialize();
 }
 
@@ -16,8 +28,10 @@ DirectedAcyclicGraph::DirectedAcyclicGraph() {
  * @param newTrapezoids is the vector which contains the new trapezoids indexes.
  * @param newTrapezoidNodes is the vector which contains the indexes of the new trapezoid nodes.
  * @param leftPointUnshared is a boolean variable which is true when the left point is a new point in the trapezoidal map, otherwise it is false.
+ * @param constructionContext contains the scratch vectors of the update.
  */
-void DirectedAcyclicGraph::update(const size_t& nodeToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, const bool& leftPointUnshared) {
+void DirectedAcyclicGraph::update(const size_t& nodeToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, const bool& leftPointUnshared, ConstructionContext& constructionContext) {
+    const size_t firstNewNode = nodes.size();
     const Node upperTrapezoidNode(Node::TRAPEZOID, newTrapezoids[0]);
     const Node lowerTrapezoidNode(Node::TRAPEZOID, newTrapezoids[1]);
 
@@ -65,8 +79,14 @@ void DirectedAcyclicGraph::update(const size_t& nodeToDelete, const size_t& left
     leftPointNode.setRightChild(nodes.size());
     nodes.push_back(rightPointNode);
 
-    // the node of the trapezoid to be deleted is update with the node of the left point
-    nodes[nodeToDelete] = leftPointNode;
+    // the node of the trapezoid to be deleted is replaced by the node of the left point, after all new nodes are stored
+    nodes[nodeToDelete].replace(leftPointNode);
+
+    std::vector<size_t>& nodesToReplace = constructionContext.nodesToReplace;
+    nodesToReplace.clear();
+    nodesToReplace.push_back(nodeToDelete);
+
+    updateDepths(firstNewNode, nodesToReplace);
 }
 
 /**
@@ -79,29 +99,38 @@ void DirectedAcyclicGraph::update(const size_t& nodeToDelete, const size_t& left
  * @param newTrapezoidNodes is the vector which contains the indexes of the new trapezoid nodes.
  * @param leftChildren is the vector which contains the indexes of the node to delete which are above of the segment, so the left children of the new segment nodes.
  * @param rightChildren is the vector which contains the indexes of the node to delete which are below of the segment, so the right children of the new segment nodes.
+ * @param constructionContext contains the scratch vectors of the update.
  */
-void DirectedAcyclicGraph::update(std::vector<size_t>& nodesToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, std::vector<size_t>& leftChildren, std::vector<size_t>& rightChildren) {
+void DirectedAcyclicGraph::update(std::vector<size_t>& nodesToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, std::vector<size_t>& leftChildren, std::vector<size_t>& rightChildren, ConstructionContext& constructionContext) {
+    // the nodes of the intersected trapezoids are replaced only after all new nodes are stored, so they are never seen half updated
+    std::vector<size_t>& nodesToReplace = constructionContext.nodesToReplace;
+    std::vector<Node>& replacingNodes = constructionContext.replacingNodes;
+    const size_t firstNewNode = nodes.size();
+
+    nodesToReplace.clear();
+    replacingNodes.clear();
+
     // if the first intersected trapezoid contains the left point of the segment
     if (leftPoint != std::numeric_limits<size_t>::max()) {
-        // the node of the first intersected trapezoid becomes a point node
-        nodes[nodesToDelete.front()].setType(Node::POINT);
+        // the node of the first intersected trapezoid will become a point node
+        Node leftPointNode(Node::POINT, leftPoint);
 
         // create the trapezoid node to the left of the left point
         const Node leftTrapezoidNode(Node::TRAPEZOID, newTrapezoids.front());
 
         // the left trapezoid node becomes the left child of the left point node
-        nodes[nodesToDelete.front()].setLeftChild(nodes.size());
+        leftPointNode.setLeftChild(nodes.size());
         newTrapezoidNodes.push_back(nodes.size());
         nodes.push_back(leftTrapezoidNode);
 
         // create the trapezoid node to the right of the left point
         const Node rightTrapezoidNode(Node::TRAPEZOID, nodes[nodesToDelete.front()].getObject());
 
-        // update the object of the left point node
-        nodes[nodesToDelete.front()].setObject(leftPoint);
-
         // the right trapezoid node becomes the right child of the left point node
-        nodes[nodesToDelete.front()].setRightChild(nodes.size());
+        leftPointNode.setRightChild(nodes.size());
+
+        nodesToReplace.push_back(nodesToDelete.front());
+        replacingNodes.push_back(leftPointNode);
 
         // update the index of the first node to delete with the index of the right trapezoid node.
         if (leftChildren.front() == nodesToDelete.front())
@@ -115,25 +144,25 @@ void DirectedAcyclicGraph::update(std::vector<size_t>& nodesToDelete, const size
 
     // if the last intersected trapezoid contains the right point of the segment
     if (rightPoint != std::numeric_limits<size_t>::max()) {
-        // the node of the last intersected trapezoid becomes a point node
-        nodes[nodesToDelete.back()].setType(Node::POINT);
+        // the node of the last intersected trapezoid will become a point node
+        Node rightPointNode(Node::POINT, rightPoint);
 
         // create the trapezoid node to the right of the right point
         const Node rightTrapezoidNode(Node::TRAPEZOID, (newTrapezoids.size() == 3) ? newTrapezoids[1] : newTrapezoids[0]);
 
         // the right trapezoid node becomes the right child of the right point node
-        nodes[nodesToDelete.back()].setRightChild(nodes.size());
+        rightPointNode.setRightChild(nodes.size());
         newTrapezoidNodes.push_back(nodes.size());
         nodes.push_back(rightTrapezoidNode);
 
         // create the trapezoid node to the left of the right point
         const Node leftTrapezoidNode(Node::TRAPEZOID, nodes[nodesToDelete.back()].getObject());
 
-        // update the object of the right point node
-        nodes[nodesToDelete.back()].setObject(rightPoint);
-
         // the left trapezoid node becomes the left child of the right point node
-        nodes[nodesToDelete.back()].setLeftChild(nodes.size());
+        rightPointNode.setLeftChild(nodes.size());
+
+        nodesToReplace.push_back(nodesToDelete.back());
+        replacingNodes.push_back(rightPointNode);
 
         // update the index of the last node to delete with the index of the left trapezoid node
         if (leftChildren.back() == nodesToDelete.back())
@@ -149,9 +178,6 @@ void DirectedAcyclicGraph::update(std::vector<size_t>& nodesToDelete, const size
     std::vector<size_t>::iterator rightChild = rightChildren.begin();
 
     for (size_t i = 0; i < nodesToDelete.size(); i++) {
-        // the node to delete becomes a segment node
-        nodes[nodesToDelete[i]].setType(Node::SEGMENT);
-
         // update the node index in the vector "leftChildren" with the new one which stores the old trapezoid
         while (leftChild != leftChildren.end() && *leftChild == nodesToDelete[i]) {
             *leftChild = nodes.size();
@@ -169,9 +195,6 @@ void DirectedAcyclicGraph::update(std::vector<size_t>& nodesToDelete, const size
 
         // create the new trapezoid node with the trapezoid stored in the node to delete
         nodes.push_back(Node(Node::TRAPEZOID, nodes[nodesToDelete[i]].getObject()));
-
-        // update the object of the segment node
-        nodes[nodesToDelete[i]].setObject(segment);
     }
 
     // update the node index in the vector "leftChildren" with the new one which stores the new trapezoid
@@ -192,18 +215,31 @@ void DirectedAcyclicGraph::update(std::vector<size_t>& nodesToDelete, const size
     // create the new trapezoid node with the new trapezoid
     nodes.push_back(Node(Node::TRAPEZOID, newTrapezoids.back()));
 
-    // update the left and the right children of the node to delete which is a segment node
+    // the nodes to delete become segment nodes, the ones created for the first and the last trapezoid are still unreachable
     for (size_t i = 0; i < nodesToDelete.size(); i++) {
-        nodes[nodesToDelete[i]].setLeftChild(leftChildren[i]);
-        nodes[nodesToDelete[i]].setRightChild(rightChildren[i]);
+        Node segmentNode(Node::SEGMENT, segment);
+        segmentNode.setLeftChild(leftChildren[i]);
+        segmentNode.setRightChild(rightChildren[i]);
+        nodes[nodesToDelete[i]].replace(segmentNode);
     }
+
+    // the point nodes are replaced last, since their children are the segment nodes just stored
+    for (size_t i = 0; i < nodesToReplace.size(); i++)
+        nodes[nodesToReplace[i]].replace(replacingNodes[i]);
+
+    // the replaced nodes are the point nodes and the nodes to delete which were not moved to a new index
+    for (const size_t& node : nodesToDelete)
+        if (node < firstNewNode)
+            nodesToReplace.push_back(node);
+
+    updateDepths(firstNewNode, nodesToReplace);
 }
 
 /**
  * @brief DirectedAcyclicGraph::getNodes returns the vector "nodes".
  * @return the vector "nodes".
  */
-const std::vector<Node>& DirectedAcyclicGraph::getNodes() const {
+const ChunkedVector<Node>& DirectedAcyclicGraph::getNodes() const {
     return nodes;
 }
 
@@ -225,18 +261,99 @@ Node& DirectedAcyclicGraph::getNode(const size_t& id) {
     return nodes[id];
 }
 
+/**
+ * @brief DirectedAcyclicGraph::getDepth returns the length of the longest path from the root to the node.
+ * @param id is the node position in the vector "nodes".
+ * @return the depth of the node.
+ */
+size_t DirectedAcyclicGraph::getDepth(const size_t& id) const {
+    return depths[id];
+}
+
+/**
+ * @brief DirectedAcyclicGraph::getMaxDepth returns the maximum depth of the nodes, which is the number of steps of the longest query.
+ * @return the maximum depth of the nodes.
+ */
+size_t DirectedAcyclicGraph::getMaxDepth() const {
+    return maxDepth;
+}
+
+/**
+ * @brief DirectedAcyclicGraph::memoryUsage returns the bytes allocated by the nodes and by their depths.
+ * @return the report of the bytes allocated by the directed acyclic graph.
+ */
+MemoryUsage DirectedAcyclicGraph::memoryUsage() const {
+    MemoryUsage memoryUsage;
+
+    memoryUsage.add("nodes", nodes.memoryUsage());
+    memoryUsage.add("depths", depths.memoryUsage());
+
+    return memoryUsage;
+}
+
+/**
+ * @brief DirectedAcyclicGraph::getMemoryResource returns the memory resource which allocates nodes and depths.
+ * @return the memory resource of the directed acyclic graph.
+ */
+std::pmr::memory_resource* DirectedAcyclicGraph::getMemoryResource() const {
+    return nodes.getMemoryResource();
+}
+
 /**
  * @brief DirectedAcyclicGraph::clear allows to delete all nodes and re-initialize the vector "nodes".
  */
 void DirectedAcyclicGraph::clear() {
     nodes.clear();
+    depths.clear();
+    maxDepth = 0;
     initialize();
 }
 
+/**
+ * @brief DirectedAcyclicGraph::swap allows the nodes of two directed acyclic graphs to be exchanged, as with one built on another thread,
+ * exchanging their chunks instead of copying them.
+ * @param other is the directed acyclic graph to be exchanged with this one.
+ */
+void DirectedAcyclicGraph::swap(DirectedAcyclicGraph& other) {
+    nodes.swap(other.nodes);
+    depths.swap(other.depths);
+    std::swap(maxDepth, other.maxDepth);
+}
+
 /**
  * @brief DirectedAcyclicGraph::initialize allows to create the default trapezoid node which represents the bounding box trapezoid.
  */
 void DirectedAcyclicGraph::initialize() {
     const Node boundingBoxNode(Node::TRAPEZOID, 0);
     nodes.push_back(boundingBoxNode);
+    depths.push_back(0);
+}
+
+/**
+ * @brief DirectedAcyclicGraph::updateDepths allows the depths of the new nodes to be computed after an update.
+ * The replaced nodes keep their depth, since their parents do not change, and the new nodes are reachable only through them.
+ * A new trapezoid node can have more parents, so it takes the maximum depth among them.
+ * @param firstNewNode is the index of the first node stored by the update.
+ * @param stack contains the indexes of the nodes replaced by the update, it is used as the stack of the visit and it is left empty.
+ */
+void DirectedAcyclicGraph::updateDepths(const size_t& firstNewNode, std::vector<size_t>& stack) {
+    while (depths.size() < nodes.size())
+        depths.push_back(0);
+
+    while (!stack.empty()) {
+        const size_t node = stack.back();
+        stack.pop_back();
+
+        if (nodes[node].getType() == Node::TRAPEZOID)
+            continue;
+
+        for (const size_t& child : {nodes[node].getLeftChild(), nodes[node].getRightChild()}) {
+            // a point node of a shared point has a null child, which is never followed
+            if (child >= firstNewNode && child != std::numeric_limits<size_t>::max() && depths[child] < depths[node] + 1) {
+                depths[child] = depths[node] + 1;
+                maxDepth = std::max(maxDepth, depths[child]);
+                stack.push_back(child);
+            }
+        }
+    }
 }
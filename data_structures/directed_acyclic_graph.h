@@ -1,31 +1,50 @@
 #ifndef DIRECTED_ACYCLIC_GRAPH_H
 #define DIRECTED_ACYCLIC_GRAPH_H
 
+#include <memory_resource>
 #include <vector>
 #include "node.h"
+#include "chunked_vector.h"
+#include "memory_usage.h"
+#include "construction_context.h"
 
 /**
  * @brief The DirectedAcyclicGraph class allows all nodes to be stored. Internal nodes contain points or segments, while leaves contain trapezoids.
  * They can be connected to other nodes using the leftChild or rightChild attribute of the class Node.
+ * An update stores the new nodes first and then replaces the nodes of the intersected trapezoids, so one thread can add segments
+ * while other threads run algorithms::query.
+ * The depth of each node is the length of the longest path from the root, so the maximum depth bounds the steps of any query.
+ * Nodes and depths are allocated from the memory resource given to the constructor.
  */
 class DirectedAcyclicGraph {
 
 public:
     DirectedAcyclicGraph();
+    explicit DirectedAcyclicGraph(std::pmr::memory_resource* memoryResource);
 
-    void update(const size_t& nodeToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, const bool& leftPointUnshared);
-    void update(std::vector<size_t>& nodesToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, std::vector<size_t>& leftChildren, std::vector<size_t>& rightChildren);
+    void update(const size_t& nodeToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, const bool& leftPointUnshared, ConstructionContext& constructionContext);
+    void update(std::vector<size_t>& nodesToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, std::vector<size_t>& newTrapezoidNodes, std::vector<size_t>& leftChildren, std::vector<size_t>& rightChildren, ConstructionContext& constructionContext);
 
-    const std::vector<Node>& getNodes() const;
+    const ChunkedVector<Node>& getNodes() const;
     const Node& getNode(const size_t& id) const;
     Node& getNode(const size_t& id);
 
+    size_t getDepth(const size_t& id) const;
+    size_t getMaxDepth() const;
+
+    MemoryUsage memoryUsage() const;
+    std::pmr::memory_resource* getMemoryResource() const;
+
     void clear();
+    void swap(DirectedAcyclicGraph& other);
 
 private:
     void initialize();
+    void updateDepths(const size_t& firstNewNode, std::vector<size_t>& stack);
 
-    std::vector<Node> nodes;
+    ChunkedVector<Node> nodes;
+    ChunkedVector<size_t> depths;
+    size_t maxDepth;
 };
 
 #endif // DIRECTED_ACYCLIC_GRAPH_H
@@ -0,0 +1,146 @@
+#include "entry_grid.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief EntryGrid::EntryGrid is the constructor of the class which creates a grid without cells.
+ * @param boundingBoxMin is the left point of the bounding box.
+ * @param boundingBoxMax is the right point of the bounding box.
+ */
+EntryGrid::EntryGrid(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax) :
+    boundingBoxMin(boundingBoxMin), boundingBoxMax(boundingBoxMax), resolution(0), cellWidth(0), cellHeight(0) {
+
+}
+
+/**
+ * @brief EntryGrid::initialize allows to create resolution x resolution cells which enter at the root of the directed acyclic graph.
+ * @param resolution is the number of cells on each side of the bounding box, 0 disables the grid.
+ */
+void EntryGrid::initialize(const size_t& resolution) {
+    clear();
+
+    this->resolution = resolution;
+
+    if (resolution == 0)
+        return;
+
+    cellWidth = (boundingBoxMax.x() - boundingBoxMin.x()) / static_cast<double>(resolution);
+    cellHeight = (boundingBoxMax.y() - boundingBoxMin.y()) / static_cast<double>(resolution);
+
+    entryNodes.assign(resolution * resolution, 0);
+    nextLeafCells.assign(resolution * resolution, std::numeric_limits<size_t>::max());
+}
+
+/**
+ * @brief EntryGrid::findCell returns the index of the cell which contains the point.
+ * @param point is the point used to find the cell.
+ * @return the index of the cell which contains the point, null if the point is outside the bounding box or the grid is empty.
+ */
+size_t EntryGrid::findCell(const cg3::Point2d& point) const {
+    if (resolution == 0 || point.x() < boundingBoxMin.x() || point.x() > boundingBoxMax.x() || point.y() < boundingBoxMin.y() || point.y() > boundingBoxMax.y())
+        return std::numeric_limits<size_t>::max();
+
+    const size_t column = std::min(static_cast<size_t>((point.x() - boundingBoxMin.x()) / cellWidth), resolution - 1);
+    const size_t row = std::min(static_cast<size_t>((point.y() - boundingBoxMin.y()) / cellHeight), resolution - 1);
+
+    return row * resolution + column;
+}
+
+/**
+ * @brief EntryGrid::getCellBoundingBox returns the bounding box of the cell, enlarged by a small margin so it also contains the points
+ * which findCell assigns to the cell after rounding.
+ * @param cell is the cell index.
+ * @return the bounding box of the cell.
+ */
+cg3::BoundingBox2 EntryGrid::getCellBoundingBox(const size_t& cell) const {
+    const double column = static_cast<double>(cell % resolution);
+    const double row = static_cast<double>(cell / resolution);
+    const double marginX = cellWidth * 1e-6;
+    const double marginY = cellHeight * 1e-6;
+
+    return cg3::BoundingBox2(cg3::Point2d(boundingBoxMin.x() + column * cellWidth - marginX, boundingBoxMin.y() + row * cellHeight - marginY),
+                             cg3::Point2d(boundingBoxMin.x() + (column + 1) * cellWidth + marginX, boundingBoxMin.y() + (row + 1) * cellHeight + marginY));
+}
+
+/**
+ * @brief EntryGrid::getResolution returns the number of cells on each side of the bounding box.
+ * @return the number of cells on each side of the bounding box.
+ */
+size_t EntryGrid::getResolution() const {
+    return resolution;
+}
+
+/**
+ * @brief EntryGrid::getCellNumber returns the number of cells.
+ * @return the number of cells.
+ */
+size_t EntryGrid::getCellNumber() const {
+    return entryNodes.size();
+}
+
+/**
+ * @brief EntryGrid::memoryUsage returns the number of bytes allocated by the entry nodes and by the index of the cells entering at trapezoid nodes.
+ * @return the number of bytes allocated by the grid.
+ */
+size_t EntryGrid::memoryUsage() const {
+    return (entryNodes.capacity() + nextLeafCells.capacity()) * sizeof(size_t) + firstLeafCells.memoryUsage();
+}
+
+/**
+ * @brief EntryGrid::getEntryNode returns the node where the queries of the cell start.
+ * @param cell is the cell index.
+ * @return the node where the queries of the cell start.
+ */
+size_t EntryGrid::getEntryNode(const size_t& cell) const {
+    return entryNodes[cell];
+}
+
+/**
+ * @brief EntryGrid::setEntryNode allows to set the node where the queries of the cell start.
+ * @param cell is the cell index.
+ * @param node is the node index.
+ * @param leaf is true if the node is a trapezoid node, so the cell is indexed by the node until it is refined.
+ */
+void EntryGrid::setEntryNode(const size_t& cell, const size_t& node, const bool& leaf) {
+    entryNodes[cell] = node;
+
+    if (leaf) {
+        size_t& firstLeafCell = firstLeafCells.insert({node, std::numeric_limits<size_t>::max()}).first->second;
+
+        nextLeafCells[cell] = firstLeafCell;
+        firstLeafCell = cell;
+    }
+}
+
+/**
+ * @brief EntryGrid::takeLeafCells allows the cells which enter at the trapezoid node to be taken, removing them from its index.
+ * The node keeps its entry without cells, since a split trapezoid node never becomes a leaf again.
+ * @param node is the index of the trapezoid node.
+ * @param cells is the vector which contains the cells which enter at the node, it is cleared first so a scratch vector can be reused.
+ */
+void EntryGrid::takeLeafCells(const size_t& node, std::vector<size_t>& cells) {
+    FlatHashMap<size_t, size_t, IndexHash>::iterator iterator = firstLeafCells.find(node);
+
+    cells.clear();
+
+    if (iterator == firstLeafCells.end())
+        return;
+
+    for (size_t cell = iterator->second; cell != std::numeric_limits<size_t>::max(); cell = nextLeafCells[cell])
+        cells.push_back(cell);
+
+    iterator->second = std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief EntryGrid::clear allows to delete all cells.
+ */
+void EntryGrid::clear() {
+    resolution = 0;
+    cellWidth = 0;
+    cellHeight = 0;
+    entryNodes.clear();
+    nextLeafCells.clear();
+    firstLeafCells.clear();
+}
@@ -0,0 +1,50 @@
+#ifndef ENTRY_GRID_H
+#define ENTRY_GRID_H
+
+#include <vector>
+#include <cg3/geometry/bounding_box2.h>
+#include "flat_hash_map.h"
+
+/**
+ * @brief The EntryGrid class allows queries of the directed acyclic graph to skip its top levels.
+ * The bounding box is split into resolution x resolution cells, and each cell stores the deepest node whose region contains the whole
+ * cell, so every point of the cell passes through that node and a query can start from it instead of the root.
+ * The cells which enter at a trapezoid node are also indexed by the node, since they can be refined when the trapezoid is split:
+ * each node stores the first of its cells, and each cell the next cell of the same node, so indexing a cell does not allocate.
+ */
+class EntryGrid {
+
+public:
+    EntryGrid(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax);
+
+    void initialize(const size_t& resolution);
+
+    size_t findCell(const cg3::Point2d& point) const;
+    cg3::BoundingBox2 getCellBoundingBox(const size_t& cell) const;
+
+    size_t getResolution() const;
+    size_t getCellNumber() const;
+    size_t memoryUsage() const;
+
+    size_t getEntryNode(const size_t& cell) const;
+    void setEntryNode(const size_t& cell, const size_t& node, const bool& leaf);
+
+    void takeLeafCells(const size_t& node, std::vector<size_t>& cells);
+
+    void clear();
+
+private:
+    cg3::Point2d boundingBoxMin;
+    cg3::Point2d boundingBoxMax;
+
+    size_t resolution;
+    double cellWidth;
+    double cellHeight;
+
+    std::vector<size_t> entryNodes;
+    std::vector<size_t> nextLeafCells;
+    FlatHashMap<size_t, size_t, IndexHash> firstLeafCells;
+
+};
+
+#endif // ENTRY_GRID_H
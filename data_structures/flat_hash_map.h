@@ -0,0 +1,322 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include <cg3/geometry/point2.h>
+
+/**
+ * @brief The FlatHashMap class allows to map keys to values with open addressing and linear probing in a single contiguous array,
+ * so an insertion does not allocate a node and a lookup usually reads one cache line.
+ * The capacity is a power of two and it is doubled when the table is three quarters full. Entries are never erased one by one,
+ * since the data structures which use it only add keys or clear everything.
+ * Iterators are pointers to the entries, which are invalidated when the table grows.
+ * The slots are allocated from a memory resource, a copy allocates from the default resource as std::pmr containers do.
+ */
+template <class Key, class Value, class Hash>
+class FlatHashMap {
+
+public:
+    typedef std::pair<Key, Value> value_type;
+    typedef value_type* iterator;
+    typedef const value_type* const_iterator;
+
+    FlatHashMap();
+    explicit FlatHashMap(std::pmr::memory_resource* memoryResource);
+
+    iterator find(const Key& key);
+    const_iterator find(const Key& key) const;
+
+    iterator end();
+    const_iterator end() const;
+
+    std::pair<iterator, bool> insert(const value_type& value);
+
+    size_t size() const;
+    bool empty() const;
+    size_t bucket_count() const;
+    size_t memoryUsage() const;
+    std::pmr::memory_resource* getMemoryResource() const;
+
+    void reserve(const size_t& elementNumber);
+    void clear();
+
+private:
+    static const size_t MIN_CAPACITY = 16;
+
+    size_t findSlot(const Key& key) const;
+    void rehash(const size_t& capacity);
+
+    std::pmr::vector<value_type> slots;
+    std::pmr::vector<unsigned char> occupied;
+
+    size_t elementNumber;
+    size_t mask;
+
+};
+
+/**
+ * @brief The HashMixer class allows the bits of a 64-bit word to be mixed with the finalizer of splitmix64, so close keys end up in
+ * distant slots of a power-of-two table.
+ */
+class HashMixer {
+
+public:
+    static size_t mix(uint64_t word) {
+        word ^= word >> 30;
+        word *= 0xbf58476d1ce4e5b9ULL;
+        word ^= word >> 27;
+        word *= 0x94d049bb133111ebULL;
+        word ^= word >> 31;
+        return static_cast<size_t>(word);
+    }
+
+    static uint64_t bits(const double& value) {
+        // 0.0 and -0.0 are equal points, so they must have the same hash
+        const double normalized = (value == 0) ? 0 : value;
+        uint64_t word;
+        std::memcpy(&word, &normalized, sizeof(word));
+        return word;
+    }
+
+};
+
+/**
+ * @brief The Point2dHash class hashes both coordinates of a point.
+ */
+class Point2dHash {
+
+public:
+    size_t operator()(const cg3::Point2d& point) const {
+        return HashMixer::mix(HashMixer::bits(point.x()) ^ HashMixer::mix(HashMixer::bits(point.y())));
+    }
+
+};
+
+/**
+ * @brief The IndexHash class hashes an index.
+ */
+class IndexHash {
+
+public:
+    size_t operator()(const size_t& index) const {
+        return HashMixer::mix(static_cast<uint64_t>(index));
+    }
+
+};
+
+/**
+ * @brief The IndexPairHash class hashes both indexes of an indexed segment.
+ */
+class IndexPairHash {
+
+public:
+    size_t operator()(const std::pair<size_t, size_t>& indexPair) const {
+        return HashMixer::mix(static_cast<uint64_t>(indexPair.first) ^ HashMixer::mix(static_cast<uint64_t>(indexPair.second)));
+    }
+
+};
+
+/**
+ * @brief FlatHashMap::FlatHashMap is the constructor of the class which creates an empty table without slots using the default memory resource.
+ */
+template <class Key, class Value, class Hash>
+FlatHashMap<Key, Value, Hash>::FlatHashMap() : FlatHashMap(std::pmr::get_default_resource()) {
+
+}
+
+/**
+ * @brief FlatHashMap::FlatHashMap is the constructor of the class which creates an empty table without slots using the given memory resource.
+ * @param memoryResource is the memory resource which allocates the slots.
+ */
+template <class Key, class Value, class Hash>
+FlatHashMap<Key, Value, Hash>::FlatHashMap(std::pmr::memory_resource* memoryResource) :
+    slots(memoryResource), occupied(memoryResource), elementNumber(0), mask(0) {
+
+}
+
+/**
+ * @brief FlatHashMap::find returns the entry with the key.
+ * @param key is the key to be found.
+ * @return the entry with the key, or end() if it is not stored.
+ */
+template <class Key, class Value, class Hash>
+typename FlatHashMap<Key, Value, Hash>::iterator FlatHashMap<Key, Value, Hash>::find(const Key& key) {
+    if (slots.empty())
+        return end();
+
+    const size_t slot = findSlot(key);
+
+    return occupied[slot] ? &slots[slot] : end();
+}
+
+/**
+ * @brief FlatHashMap::find returns the entry with the key.
+ * @param key is the key to be found.
+ * @return the entry with the key, or end() if it is not stored.
+ */
+template <class Key, class Value, class Hash>
+typename FlatHashMap<Key, Value, Hash>::const_iterator FlatHashMap<Key, Value, Hash>::find(const Key& key) const {
+    if (slots.empty())
+        return end();
+
+    const size_t slot = findSlot(key);
+
+    return occupied[slot] ? &slots[slot] : end();
+}
+
+/**
+ * @brief FlatHashMap::end returns the iterator which represents a missing entry.
+ * @return the iterator which represents a missing entry.
+ */
+template <class Key, class Value, class Hash>
+typename FlatHashMap<Key, Value, Hash>::iterator FlatHashMap<Key, Value, Hash>::end() {
+    return nullptr;
+}
+
+/**
+ * @brief FlatHashMap::end returns the iterator which represents a missing entry.
+ * @return the iterator which represents a missing entry.
+ */
+template <class Key, class Value, class Hash>
+typename FlatHashMap<Key, Value, Hash>::const_iterator FlatHashMap<Key, Value, Hash>::end() const {
+    return nullptr;
+}
+
+/**
+ * @brief FlatHashMap::insert allows to store the entry if its key is not stored yet.
+ * @param value is the entry to be stored.
+ * @return the entry with the key and true if it has been stored, false if the key was already stored.
+ */
+template <class Key, class Value, class Hash>
+std::pair<typename FlatHashMap<Key, Value, Hash>::iterator, bool> FlatHashMap<Key, Value, Hash>::insert(const value_type& value) {
+    if (4 * (elementNumber + 1) > 3 * slots.size())
+        rehash(std::max(2 * slots.size(), size_t(MIN_CAPACITY)));
+
+    const size_t slot = findSlot(value.first);
+
+    if (occupied[slot])
+        return std::make_pair(&slots[slot], false);
+
+    slots[slot] = value;
+    occupied[slot] = 1;
+    elementNumber++;
+
+    return std::make_pair(&slots[slot], true);
+}
+
+/**
+ * @brief FlatHashMap::size returns the number of stored entries.
+ * @return the number of stored entries.
+ */
+template <class Key, class Value, class Hash>
+size_t FlatHashMap<Key, Value, Hash>::size() const {
+    return elementNumber;
+}
+
+/**
+ * @brief FlatHashMap::empty returns whether no entry is stored.
+ * @return true if no entry is stored, otherwise false.
+ */
+template <class Key, class Value, class Hash>
+bool FlatHashMap<Key, Value, Hash>::empty() const {
+    return elementNumber == 0;
+}
+
+/**
+ * @brief FlatHashMap::bucket_count returns the number of slots.
+ * @return the number of slots.
+ */
+template <class Key, class Value, class Hash>
+size_t FlatHashMap<Key, Value, Hash>::bucket_count() const {
+    return slots.size();
+}
+
+/**
+ * @brief FlatHashMap::memoryUsage returns the number of bytes allocated by the slots and by their occupancy flags.
+ * @return the number of bytes allocated by the table.
+ */
+template <class Key, class Value, class Hash>
+size_t FlatHashMap<Key, Value, Hash>::memoryUsage() const {
+    return slots.capacity() * sizeof(value_type) + occupied.capacity() * sizeof(unsigned char);
+}
+
+/**
+ * @brief FlatHashMap::getMemoryResource returns the memory resource which allocates the slots.
+ * @return the memory resource of the table.
+ */
+template <class Key, class Value, class Hash>
+std::pmr::memory_resource* FlatHashMap<Key, Value, Hash>::getMemoryResource() const {
+    return slots.get_allocator().resource();
+}
+
+/**
+ * @brief FlatHashMap::reserve allows the table to grow once so it can store the entries without growing again.
+ * @param elementNumber is the number of entries to be stored.
+ */
+template <class Key, class Value, class Hash>
+void FlatHashMap<Key, Value, Hash>::reserve(const size_t& elementNumber) {
+    size_t capacity = std::max(slots.size(), size_t(MIN_CAPACITY));
+
+    while (4 * elementNumber > 3 * capacity)
+        capacity *= 2;
+
+    if (capacity != slots.size())
+        rehash(capacity);
+}
+
+/**
+ * @brief FlatHashMap::clear allows to delete all entries and to release the slots.
+ */
+template <class Key, class Value, class Hash>
+void FlatHashMap<Key, Value, Hash>::clear() {
+    std::pmr::vector<value_type>(slots.get_allocator()).swap(slots);
+    std::pmr::vector<unsigned char>(occupied.get_allocator()).swap(occupied);
+    elementNumber = 0;
+    mask = 0;
+}
+
+/**
+ * @brief FlatHashMap::findSlot returns the slot which stores the key, or the empty slot where the probing of the key stops.
+ * The table always has an empty slot, since it is never full.
+ * @param key is the key to be found.
+ * @return the slot which stores the key or the empty slot where it would be stored.
+ */
+template <class Key, class Value, class Hash>
+size_t FlatHashMap<Key, Value, Hash>::findSlot(const Key& key) const {
+    size_t slot = Hash()(key) & mask;
+
+    while (occupied[slot] && !(slots[slot].first == key))
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+/**
+ * @brief FlatHashMap::rehash allows the entries to be moved into a table with the given capacity.
+ * @param capacity is the new number of slots, a power of two.
+ */
+template <class Key, class Value, class Hash>
+void FlatHashMap<Key, Value, Hash>::rehash(const size_t& capacity) {
+    std::pmr::vector<value_type> oldSlots(capacity, slots.get_allocator());
+    std::pmr::vector<unsigned char> oldOccupied(capacity, 0, occupied.get_allocator());
+
+    oldSlots.swap(slots);
+    oldOccupied.swap(occupied);
+    mask = capacity - 1;
+
+    for (size_t i = 0; i < oldSlots.size(); i++) {
+        if (oldOccupied[i]) {
+            const size_t slot = findSlot(oldSlots[i].first);
+            slots[slot] = oldSlots[i];
+            occupied[slot] = 1;
+        }
+    }
+}
+
+#endif // FLAT_HASH_MAP_H
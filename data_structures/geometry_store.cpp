@@ -0,0 +1,321 @@
+#include "geometry_store.h"
+
+#include <cassert>
+
+/**
+ * @brief GeometryStore::GeometryStore is the constructor of the class which creates an empty store without corners using the default memory resource.
+ */
+GeometryStore::GeometryStore() :
+    GeometryStore(std::pmr::get_default_resource()) {
+
+}
+
+/**
+ * @brief GeometryStore::GeometryStore is the constructor of the class which creates an empty store without corners using the given memory resource.
+ * @param memoryResource is the memory resource which allocates points, segments and the tables of duplicates.
+ */
+GeometryStore::GeometryStore(std::pmr::memory_resource* memoryResource) :
+    points(memoryResource), indexedSegments(memoryResource), pointMap(memoryResource), segmentMap(memoryResource),
+    boundingBox(cg3::Point2d(0,0), cg3::Point2d(0,0)), cornerNumber(0) {
+
+}
+
+/**
+ * @brief GeometryStore::setCorners allows the corners of the bounding box trapezoid to be stored as the first two points.
+ * They are not part of the bounding box of the store and they are stored again after each clear.
+ * @param boundingBoxMin is the left point of the bounding box trapezoid.
+ * @param boundingBoxMax is the right point of the bounding box trapezoid.
+ */
+void GeometryStore::setCorners(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax) {
+    assert(points.empty());
+
+    points.push_back(boundingBoxMin);
+    pointMap.insert(std::make_pair(boundingBoxMin, size_t(0)));
+
+    points.push_back(boundingBoxMax);
+    pointMap.insert(std::make_pair(boundingBoxMax, size_t(1)));
+
+    cornerNumber = 2;
+}
+
+/**
+ * @brief GeometryStore::getCornerNumber returns the number of points which are corners of the bounding box trapezoid.
+ * @return 2 if the corners have been set, otherwise 0.
+ */
+size_t GeometryStore::getCornerNumber() const {
+    return cornerNumber;
+}
+
+/**
+ * @brief GeometryStore::addPoint allows the new point to be stored if it is not in the vector "points" and returns its position.
+ * @param point is the new point.
+ * @param pointInserted is true if the point has been stored, false if it was already stored.
+ * @return the point position in the vector "points".
+ */
+size_t GeometryStore::addPoint(const cg3::Point2d& point, bool& pointInserted) {
+    bool found;
+    size_t id = findPoint(point, found);
+
+    pointInserted = false;
+
+    //Point will be inserted
+    if (!found) {
+        pointInserted = true;
+
+        id = points.size();
+
+        //Add point
+        points.push_back(point);
+
+        pointMap.insert(std::make_pair(point, id));
+
+        //Update bounding box
+        boundingBox.setMax(cg3::Point2d(
+                std::max(point.x(), boundingBox.max().x()),
+                std::max(point.y(), boundingBox.max().y())));
+        boundingBox.setMin(cg3::Point2d(
+                std::min(point.x(), boundingBox.min().x()),
+                std::min(point.y(), boundingBox.min().y())));
+    }
+
+    return id;
+}
+
+/**
+ * @brief GeometryStore::addSegment allows the new segment to be stored if it is not degenerate and it is not in the vector "indexedSegments".
+ * @param segment is the new segment.
+ * @param segmentInserted is true if the segment has been stored, false if it was already stored or it is degenerate.
+ * @return the indexed segment position in the vector "indexedSegments", or null if the segment is degenerate.
+ */
+size_t GeometryStore::addSegment(const cg3::Segment2d& segment, bool& segmentInserted) {
+    cg3::Segment2d orderedSegment = segment;
+    if (segment.p2() < segment.p1()) {
+        orderedSegment.setP1(segment.p2());
+        orderedSegment.setP2(segment.p1());
+    }
+
+    segmentInserted = false;
+
+    if (orderedSegment.p1() == orderedSegment.p2())
+        return std::numeric_limits<size_t>::max();
+
+    bool found;
+    size_t id = findSegment(orderedSegment, found);
+
+    if (!found) {
+        segmentInserted = true;
+
+        id = indexedSegments.size();
+
+        bool pointInserted;
+        IndexedSegment2d indexedSegment(addPoint(orderedSegment.p1(), pointInserted), addPoint(orderedSegment.p2(), pointInserted));
+
+        indexedSegments.push_back(indexedSegment);
+
+        segmentMap.insert(std::make_pair(indexedSegment, id));
+    }
+
+    return id;
+}
+
+/**
+ * @brief GeometryStore::addIndexedSegment allows the new segment between two stored points to be stored if it is not degenerate
+ * and it is not in the vector "indexedSegments".
+ * @param indexedSegment is the new indexed segment.
+ * @param segmentInserted is true if the segment has been stored, false if it was already stored or it is degenerate.
+ * @return the indexed segment position in the vector "indexedSegments", or null if the segment is degenerate.
+ */
+size_t GeometryStore::addIndexedSegment(const IndexedSegment2d& indexedSegment, bool& segmentInserted) {
+    segmentInserted = false;
+
+    if (indexedSegment.first == indexedSegment.second)
+        return std::numeric_limits<size_t>::max();
+
+    return addSegment(cg3::Segment2d(points[indexedSegment.first], points[indexedSegment.second]), segmentInserted);
+}
+
+/**
+ * @brief GeometryStore::findPoint returns the point position in the vector "points" if it is stored or null.
+ * @param point is the point to be found.
+ * @param found is a boolean variable.
+ * @return the point position in the vector "points" if it is stored or null.
+ */
+size_t GeometryStore::findPoint(const cg3::Point2d& point, bool& found) const {
+    FlatHashMap<cg3::Point2d, size_t, Point2dHash>::const_iterator it = pointMap.find(point);
+
+    //Point already in the data structure
+    if (it != pointMap.end()) {
+        found = true;
+        return it->second;
+    }
+    //Point not in the data structure
+    else {
+        found = false;
+        return std::numeric_limits<size_t>::max();
+    }
+}
+
+/**
+ * @brief GeometryStore::findSegment returns the indexed segment position in the vector "indexedSegments" if it is stored or null.
+ * @param segment is the segment to be found.
+ * @param found is a boolean variable.
+ * @return the indexed segment position in the vector "indexedSegments" if it is stored or null.
+ */
+size_t GeometryStore::findSegment(const cg3::Segment2d& segment, bool& found) const {
+    found = false;
+
+    bool foundPoint1;
+    size_t id1 = findPoint(segment.p1(), foundPoint1);
+    if (!foundPoint1)
+        return std::numeric_limits<size_t>::max();
+
+    bool foundPoint2;
+    size_t id2 = findPoint(segment.p2(), foundPoint2);
+    if (!foundPoint2)
+        return std::numeric_limits<size_t>::max();
+
+    return findIndexedSegment(IndexedSegment2d(id1, id2), found);
+}
+
+/**
+ * @brief GeometryStore::findIndexedSegment returns the indexed segment position in the vector "indexedSegments" if it is stored or null.
+ * @param indexedSegment is the indexed segment to be found, its points can be in any order.
+ * @param found is a boolean variable.
+ * @return the indexed segment position in the vector "indexedSegments" if it is stored or null.
+ */
+size_t GeometryStore::findIndexedSegment(const IndexedSegment2d& indexedSegment, bool& found) const {
+    IndexedSegment2d orderedIndexedSegment = indexedSegment;
+    if (points[indexedSegment.second] < points[indexedSegment.first]) {
+        orderedIndexedSegment.first = indexedSegment.second;
+        orderedIndexedSegment.second = indexedSegment.first;
+    }
+
+    FlatHashMap<IndexedSegment2d, size_t, IndexPairHash>::const_iterator it = segmentMap.find(orderedIndexedSegment);
+
+    //Segment already in the data structure
+    if (it != segmentMap.end()) {
+        found = true;
+        return it->second;
+    }
+    //Segment not in the data structure
+    else {
+        found = false;
+        return std::numeric_limits<size_t>::max();
+    }
+}
+
+/**
+ * @brief GeometryStore::getPoints returns the vector "points".
+ * @return the vector "points".
+ */
+const ChunkedVector<cg3::Point2d>& GeometryStore::getPoints() const {
+    return points;
+}
+
+/**
+ * @brief GeometryStore::getPoint returns the point in the vector "points" in the position "id".
+ * @param id is the point position in the vector "points".
+ * @return the point in the vector "points" in the position "id".
+ */
+const cg3::Point2d& GeometryStore::getPoint(const size_t& id) const {
+    return points[id];
+}
+
+/**
+ * @brief GeometryStore::getSegment returns the Segment object with the points of the indexed segment in the vector "indexedSegments" in the position "id".
+ * @param id is the indexed segment position in the vector "indexedSegments".
+ * @return the Segment object with the points of the indexed segment in the vector "indexedSegments" in the position "id".
+ */
+cg3::Segment2d GeometryStore::getSegment(const size_t& id) const {
+    return cg3::Segment2d(points[indexedSegments[id].first], points[indexedSegments[id].second]);
+}
+
+/**
+ * @brief GeometryStore::getIndexedSegments returns the vector "indexedSegments".
+ * @return the vector "indexedSegments".
+ */
+const ChunkedVector<GeometryStore::IndexedSegment2d>& GeometryStore::getIndexedSegments() const {
+    return indexedSegments;
+}
+
+/**
+ * @brief GeometryStore::getIndexedSegment returns the indexed segment in the vector "indexedSegments" in the position "id".
+ * @param id is the indexed segment position in the vector "indexedSegments".
+ * @return the indexed segment in the vector "indexedSegments" in the position "id".
+ */
+const GeometryStore::IndexedSegment2d& GeometryStore::getIndexedSegment(const size_t& id) const {
+    return indexedSegments[id];
+}
+
+/**
+ * @brief GeometryStore::getBoundingBox returns the bounding box of the points which are not corners.
+ * @return the bounding box of the points which are not corners.
+ */
+const cg3::BoundingBox2& GeometryStore::getBoundingBox() const {
+    return boundingBox;
+}
+
+/**
+ * @brief GeometryStore::memoryUsage returns the bytes allocated by each container of the store.
+ * @return the report of the bytes allocated by the store.
+ */
+MemoryUsage GeometryStore::memoryUsage() const {
+    MemoryUsage memoryUsage;
+
+    memoryUsage.add("points", points.memoryUsage());
+    memoryUsage.add("indexedSegments", indexedSegments.memoryUsage());
+    memoryUsage.add("pointMap", pointMap.memoryUsage());
+    memoryUsage.add("segmentMap", segmentMap.memoryUsage());
+    memoryUsage.setSegmentNumber(indexedSegments.size());
+
+    return memoryUsage;
+}
+
+/**
+ * @brief GeometryStore::getMemoryResource returns the memory resource which allocates the containers of the store.
+ * @return the memory resource of the store.
+ */
+std::pmr::memory_resource* GeometryStore::getMemoryResource() const {
+    return points.getMemoryResource();
+}
+
+/**
+ * @brief GeometryStore::snapshot returns a copy of the store which shares the unchanged points and segments with it.
+ * The tables used to find duplicate points and segments are not copied, since the snapshot is only read.
+ * @return the copy of the store.
+ */
+GeometryStore GeometryStore::snapshot() const {
+    return GeometryStore(points, indexedSegments, boundingBox, cornerNumber);
+}
+
+/**
+ * @brief GeometryStore::clear allows to delete all points and segments, the corners of the bounding box trapezoid are stored again.
+ */
+void GeometryStore::clear() {
+    const bool corners = cornerNumber > 0;
+    const cg3::Point2d boundingBoxMin = corners ? points[0] : cg3::Point2d();
+    const cg3::Point2d boundingBoxMax = corners ? points[1] : cg3::Point2d();
+
+    points.clear();
+    indexedSegments.clear();
+    pointMap.clear();
+    segmentMap.clear();
+    boundingBox.setMin(cg3::Point2d(0,0));
+    boundingBox.setMax(cg3::Point2d(0,0));
+    cornerNumber = 0;
+
+    if (corners)
+        setCorners(boundingBoxMin, boundingBoxMax);
+}
+
+/**
+ * @brief GeometryStore::GeometryStore is the constructor of the class used by snapshot, which shares the given vectors without the tables of duplicates.
+ * @param points are the points to be shared.
+ * @param indexedSegments are the indexed segments to be shared.
+ * @param boundingBox is the bounding box of the points which are not corners.
+ * @param cornerNumber is the number of points which are corners of the bounding box trapezoid.
+ */
+GeometryStore::GeometryStore(const ChunkedVector<cg3::Point2d>& points, const ChunkedVector<IndexedSegment2d>& indexedSegments, const cg3::BoundingBox2& boundingBox, const size_t& cornerNumber) :
+    points(points), indexedSegments(indexedSegments), boundingBox(boundingBox), cornerNumber(cornerNumber) {
+
+}
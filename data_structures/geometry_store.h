@@ -0,0 +1,70 @@
+#ifndef GEOMETRY_STORE_H
+#define GEOMETRY_STORE_H
+
+#include <memory_resource>
+
+#include <cg3/geometry/point2.h>
+#include <cg3/geometry/segment2.h>
+#include <cg3/geometry/bounding_box2.h>
+#include "chunked_vector.h"
+#include "flat_hash_map.h"
+#include "memory_usage.h"
+
+/**
+ * @brief The GeometryStore class allows to store non-duplicate points and indexed segments once, so the dataset and the trapezoidal map
+ * can refer to the same geometry by index. Segments are stored with the lexicographically smaller point first.
+ * The first getCornerNumber() points are the corners of the bounding box trapezoid, which are kept by clear.
+ * All containers allocate from the memory resource given to the constructor, a snapshot allocates from the default resource.
+ */
+class GeometryStore {
+
+public:
+    typedef std::pair<size_t, size_t> IndexedSegment2d;
+
+    GeometryStore();
+    explicit GeometryStore(std::pmr::memory_resource* memoryResource);
+
+    void setCorners(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax);
+    size_t getCornerNumber() const;
+
+    size_t addPoint(const cg3::Point2d& point, bool& pointInserted);
+    size_t addSegment(const cg3::Segment2d& segment, bool& segmentInserted);
+    size_t addIndexedSegment(const IndexedSegment2d& indexedSegment, bool& segmentInserted);
+
+    size_t findPoint(const cg3::Point2d& point, bool& found) const;
+    size_t findSegment(const cg3::Segment2d& segment, bool& found) const;
+    size_t findIndexedSegment(const IndexedSegment2d& indexedSegment, bool& found) const;
+
+    const ChunkedVector<cg3::Point2d>& getPoints() const;
+    const cg3::Point2d& getPoint(const size_t& id) const;
+
+    cg3::Segment2d getSegment(const size_t& id) const;
+
+    const ChunkedVector<IndexedSegment2d>& getIndexedSegments() const;
+    const IndexedSegment2d& getIndexedSegment(const size_t& id) const;
+
+    const cg3::BoundingBox2& getBoundingBox() const;
+
+    MemoryUsage memoryUsage() const;
+    std::pmr::memory_resource* getMemoryResource() const;
+
+    GeometryStore snapshot() const;
+
+    void clear();
+
+private:
+    GeometryStore(const ChunkedVector<cg3::Point2d>& points, const ChunkedVector<IndexedSegment2d>& indexedSegments, const cg3::BoundingBox2& boundingBox, const size_t& cornerNumber);
+
+    ChunkedVector<cg3::Point2d> points;
+    ChunkedVector<IndexedSegment2d> indexedSegments;
+
+    FlatHashMap<cg3::Point2d, size_t, Point2dHash> pointMap;
+    FlatHashMap<IndexedSegment2d, size_t, IndexPairHash> segmentMap;
+
+    cg3::BoundingBox2 boundingBox;
+
+    size_t cornerNumber;
+
+};
+
+#endif // GEOMETRY_STORE_H
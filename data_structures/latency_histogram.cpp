@@ -0,0 +1,213 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+const size_t LatencyHistogram::SUB_BUCKET_BITS;
+const size_t LatencyHistogram::SUB_BUCKET_NUMBER;
+const size_t LatencyHistogram::BUCKET_NUMBER;
+
+const char* const LatencyHistogram::CSV_HEADER = "operation,bucket_min_ns,bucket_max_ns,count,cumulative_fraction";
+
+/**
+ * @brief LatencyHistogram::LatencyHistogram is the constructor of the class, no latency is recorded.
+ */
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+/**
+ * @brief LatencyHistogram::record allows a latency to be counted in its bucket.
+ * @param nanoseconds is the latency in nanoseconds.
+ */
+void LatencyHistogram::record(const uint64_t& nanoseconds) {
+    bucketCounts[getBucket(nanoseconds)]++;
+    count++;
+    total += nanoseconds;
+    max = std::max(max, nanoseconds);
+}
+
+/**
+ * @brief LatencyHistogram::recordSince allows the time elapsed since the start of an operation to be recorded.
+ * @param start is the time when the operation started.
+ */
+void LatencyHistogram::recordSince(const std::chrono::steady_clock::time_point& start) {
+    record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+}
+
+/**
+ * @brief LatencyHistogram::merge allows the latencies recorded by another histogram to be added to this one.
+ * @param other is the histogram to be merged.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t bucket = 0; bucket < BUCKET_NUMBER; bucket++)
+        bucketCounts[bucket] += other.bucketCounts[bucket];
+
+    count += other.count;
+    total += other.total;
+    max = std::max(max, other.max);
+}
+
+/**
+ * @brief LatencyHistogram::reset allows all recorded latencies to be deleted.
+ */
+void LatencyHistogram::reset() {
+    bucketCounts.fill(0);
+    count = 0;
+    total = 0;
+    max = 0;
+}
+
+/**
+ * @brief LatencyHistogram::getCount returns the number of recorded latencies.
+ * @return the number of recorded latencies.
+ */
+uint64_t LatencyHistogram::getCount() const {
+    return count;
+}
+
+/**
+ * @brief LatencyHistogram::getMean returns the exact mean of the recorded latencies.
+ * @return the mean latency in nanoseconds, 0 if nothing has been recorded.
+ */
+double LatencyHistogram::getMean() const {
+    return count > 0 ? static_cast<double>(total) / static_cast<double>(count) : 0;
+}
+
+/**
+ * @brief LatencyHistogram::getMax returns the exact maximum of the recorded latencies.
+ * @return the maximum latency in nanoseconds, 0 if nothing has been recorded.
+ */
+uint64_t LatencyHistogram::getMax() const {
+    return max;
+}
+
+/**
+ * @brief LatencyHistogram::getPercentile returns the latency below which the given percentage of the recorded latencies falls,
+ * that is the upper bound of the bucket which contains it, without exceeding the maximum.
+ * @param percentile is the percentage, from 0 to 100.
+ * @return the percentile in nanoseconds, 0 if nothing has been recorded.
+ */
+uint64_t LatencyHistogram::getPercentile(const double& percentile) const {
+    if (count == 0)
+        return 0;
+
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * static_cast<double>(count))));
+    uint64_t cumulativeCount = 0;
+
+    for (size_t bucket = 0; bucket < BUCKET_NUMBER; bucket++) {
+        cumulativeCount += bucketCounts[bucket];
+
+        if (cumulativeCount >= rank)
+            return std::min(getBucketMax(bucket), max);
+    }
+
+    return max;
+}
+
+/**
+ * @brief LatencyHistogram::getBucketCount returns the number of latencies recorded in a bucket.
+ * @param bucket is the index of the bucket.
+ * @return the number of latencies in the bucket.
+ */
+uint64_t LatencyHistogram::getBucketCount(const size_t& bucket) const {
+    return bucketCounts[bucket];
+}
+
+/**
+ * @brief LatencyHistogram::getBucketMin returns the lowest latency counted in a bucket.
+ * @param bucket is the index of the bucket.
+ * @return the lowest latency of the bucket in nanoseconds.
+ */
+uint64_t LatencyHistogram::getBucketMin(const size_t& bucket) {
+    if (bucket < SUB_BUCKET_NUMBER)
+        return bucket;
+
+    const size_t shift = (bucket - SUB_BUCKET_NUMBER) / SUB_BUCKET_NUMBER;
+    return static_cast<uint64_t>(SUB_BUCKET_NUMBER + bucket % SUB_BUCKET_NUMBER) << shift;
+}
+
+/**
+ * @brief LatencyHistogram::getBucketMax returns the highest latency counted in a bucket.
+ * @param bucket is the index of the bucket.
+ * @return the highest latency of the bucket in nanoseconds.
+ */
+uint64_t LatencyHistogram::getBucketMax(const size_t& bucket) {
+    return bucket + 1 < BUCKET_NUMBER ? getBucketMin(bucket + 1) - 1 : UINT64_MAX;
+}
+
+/**
+ * @brief LatencyHistogram::toString returns the number of latencies, their mean, the 50th, 90th and 99th percentiles and the maximum in microseconds.
+ * @return the summary of the recorded latencies.
+ */
+std::string LatencyHistogram::toString() const {
+    std::ostringstream stream;
+
+    stream << std::fixed << std::setprecision(1) << count << " | mean " << getMean() / 1000 << " | p50 " << getPercentile(50) / 1000.0
+           << " | p90 " << getPercentile(90) / 1000.0 << " | p99 " << getPercentile(99) / 1000.0 << " | max " << max / 1000.0 << " us";
+
+    return stream.str();
+}
+
+/**
+ * @brief LatencyHistogram::toCsv returns a line for each bucket which contains some latencies, with its bounds, its count and the fraction of
+ * latencies up to its upper bound. The columns are those of CSV_HEADER.
+ * @param operation is the name of the measured operation, written in the first column.
+ * @return the lines of the non-empty buckets.
+ */
+std::string LatencyHistogram::toCsv(const std::string& operation) const {
+    std::ostringstream stream;
+    uint64_t cumulativeCount = 0;
+
+    for (size_t bucket = 0; bucket < BUCKET_NUMBER; bucket++) {
+        if (bucketCounts[bucket] == 0)
+            continue;
+
+        cumulativeCount += bucketCounts[bucket];
+        stream << operation << "," << getBucketMin(bucket) << "," << getBucketMax(bucket) << "," << bucketCounts[bucket] << ","
+               << static_cast<double>(cumulativeCount) / static_cast<double>(count) << "\n";
+    }
+
+    return stream.str();
+}
+
+/**
+ * @brief LatencyHistogram::getBucket returns the bucket of a latency: below 2^SUB_BUCKET_BITS it is the latency itself, otherwise the bucket
+ * is given by the position of the highest bit and by the SUB_BUCKET_BITS bits which follow it.
+ * @param nanoseconds is the latency in nanoseconds.
+ * @return the index of the bucket.
+ */
+size_t LatencyHistogram::getBucket(const uint64_t& nanoseconds) {
+    if (nanoseconds < SUB_BUCKET_NUMBER)
+        return static_cast<size_t>(nanoseconds);
+
+    const size_t shift = getHighestBit(nanoseconds) - SUB_BUCKET_BITS;
+    return SUB_BUCKET_NUMBER * (shift + 1) + static_cast<size_t>((nanoseconds >> shift) - SUB_BUCKET_NUMBER);
+}
+
+/**
+ * @brief LatencyHistogram::getHighestBit returns the position of the highest set bit, counting the leading zeros with one instruction
+ * where the compiler provides it.
+ * @param value is the value, which must not be 0.
+ * @return the position of the highest set bit, from 0 to 63.
+ */
+size_t LatencyHistogram::getHighestBit(const uint64_t& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast<size_t>(__builtin_clzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long highestBit;
+    _BitScanReverse64(&highestBit, value);
+    return highestBit;
+#else
+    size_t highestBit = 0;
+    while (highestBit < 63 && (value >> (highestBit + 1)) != 0)
+        highestBit++;
+    return highestBit;
+#endif
+}
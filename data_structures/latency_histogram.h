@@ -0,0 +1,54 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief The LatencyHistogram class allows to record the latencies of many operations with constant memory and time, as an HDR histogram.
+ * Latencies are recorded in nanoseconds: values below 2^SUB_BUCKET_BITS have a bucket each, while each larger power of two is split into
+ * 2^SUB_BUCKET_BITS buckets of the same width, so the percentiles are the upper bounds of their buckets, with a relative error below 1/32.
+ * It is not synchronized, the latencies of another thread can be recorded in its own histogram and merged.
+ */
+class LatencyHistogram {
+
+public:
+    static const size_t SUB_BUCKET_BITS = 5;
+    static const size_t SUB_BUCKET_NUMBER = size_t(1) << SUB_BUCKET_BITS;
+    static const size_t BUCKET_NUMBER = SUB_BUCKET_NUMBER * (64 - SUB_BUCKET_BITS + 1);
+
+    LatencyHistogram();
+
+    void record(const uint64_t& nanoseconds);
+    void recordSince(const std::chrono::steady_clock::time_point& start);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t getCount() const;
+    double getMean() const;
+    uint64_t getMax() const;
+    uint64_t getPercentile(const double& percentile) const;
+
+    uint64_t getBucketCount(const size_t& bucket) const;
+    static uint64_t getBucketMin(const size_t& bucket);
+    static uint64_t getBucketMax(const size_t& bucket);
+
+    std::string toString() const;
+    std::string toCsv(const std::string& operation) const;
+
+    static const char* const CSV_HEADER;
+
+private:
+    static size_t getBucket(const uint64_t& nanoseconds);
+    static size_t getHighestBit(const uint64_t& value);
+
+    std::array<uint64_t, BUCKET_NUMBER> bucketCounts;
+    uint64_t count;
+    uint64_t total;
+    uint64_t max;
+
+};
+
+#endif // LATENCY_HISTOGRAM_H
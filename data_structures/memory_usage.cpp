@@ -0,0 +1,90 @@
+#include "memory_usage.h"
+
+#include <sstream>
+
+/**
+ * @brief MemoryUsage::MemoryUsage is the constructor of the class which creates an empty report.
+ */
+MemoryUsage::MemoryUsage() :
+    segmentNumber(0) {
+
+}
+
+/**
+ * @brief MemoryUsage::add allows to store the bytes allocated by a container.
+ * @param name is the name of the container.
+ * @param bytes is the number of bytes allocated by the container.
+ */
+void MemoryUsage::add(const std::string& name, const size_t& bytes) {
+    entries.push_back(Entry(name, bytes));
+}
+
+/**
+ * @brief MemoryUsage::add allows to store the entries of another report, whose names are preceded by the prefix.
+ * @param prefix is the name of the data structure of the other report.
+ * @param memoryUsage is the other report.
+ */
+void MemoryUsage::add(const std::string& prefix, const MemoryUsage& memoryUsage) {
+    for (const Entry& entry : memoryUsage.entries)
+        entries.push_back(Entry(prefix + "." + entry.first, entry.second));
+}
+
+/**
+ * @brief MemoryUsage::getEntries returns the name and the bytes of each container.
+ * @return the name and the bytes of each container.
+ */
+const std::vector<MemoryUsage::Entry>& MemoryUsage::getEntries() const {
+    return entries;
+}
+
+/**
+ * @brief MemoryUsage::getTotal returns the number of bytes allocated by all containers.
+ * @return the number of bytes allocated by all containers.
+ */
+size_t MemoryUsage::getTotal() const {
+    size_t total = 0;
+
+    for (const Entry& entry : entries)
+        total += entry.second;
+
+    return total;
+}
+
+/**
+ * @brief MemoryUsage::setSegmentNumber allows to set the number of segments stored by the data structures of the report.
+ * @param segmentNumber is the number of segments.
+ */
+void MemoryUsage::setSegmentNumber(const size_t& segmentNumber) {
+    this->segmentNumber = segmentNumber;
+}
+
+/**
+ * @brief MemoryUsage::getSegmentNumber returns the number of segments stored by the data structures of the report.
+ * @return the number of segments.
+ */
+size_t MemoryUsage::getSegmentNumber() const {
+    return segmentNumber;
+}
+
+/**
+ * @brief MemoryUsage::getBytesPerSegment returns the number of bytes allocated for each segment.
+ * @return the number of bytes allocated for each segment, 0 if there are no segments.
+ */
+double MemoryUsage::getBytesPerSegment() const {
+    return (segmentNumber == 0) ? 0 : static_cast<double>(getTotal()) / static_cast<double>(segmentNumber);
+}
+
+/**
+ * @brief MemoryUsage::toString returns one line for each container, followed by the total and the bytes per segment.
+ * @return the text of the report.
+ */
+std::string MemoryUsage::toString() const {
+    std::ostringstream stream;
+
+    for (const Entry& entry : entries)
+        stream << entry.first << ": " << entry.second << " bytes" << std::endl;
+
+    stream << "Total: " << getTotal() << " bytes, " << getBytesPerSegment() << " bytes per segment";
+
+    return stream.str();
+}
@@ -0,0 +1,67 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+/**
+ * @brief The MemoryUsage class allows to report the bytes allocated by each container of a data structure and the bytes per segment.
+ * Node-based hash tables are estimated from their size and bucket count, since their allocations are not visible: every entry is
+ * a node with the next pointer, the cached hash and the element, and every bucket is a pointer.
+ */
+class MemoryUsage {
+
+public:
+    typedef std::pair<std::string, size_t> Entry;
+
+    MemoryUsage();
+
+    void add(const std::string& name, const size_t& bytes);
+    void add(const std::string& prefix, const MemoryUsage& memoryUsage);
+
+    const std::vector<Entry>& getEntries() const;
+    size_t getTotal() const;
+
+    void setSegmentNumber(const size_t& segmentNumber);
+    size_t getSegmentNumber() const;
+    double getBytesPerSegment() const;
+
+    std::string toString() const;
+
+    template <class Key, class Value, class Hash, class Equal, class Allocator>
+    static size_t hashTableBytes(const std::unordered_map<Key, Value, Hash, Equal, Allocator>& hashTable);
+
+    template <class T, class Allocator>
+    static size_t vectorBytes(const std::vector<T, Allocator>& vector);
+
+private:
+    std::vector<Entry> entries;
+    size_t segmentNumber;
+
+};
+
+/**
+ * @brief MemoryUsage::hashTableBytes returns the estimated number of bytes allocated by a node-based hash table.
+ * @param hashTable is the hash table.
+ * @return the estimated number of bytes allocated by the hash table.
+ */
+template <class Key, class Value, class Hash, class Equal, class Allocator>
+size_t MemoryUsage::hashTableBytes(const std::unordered_map<Key, Value, Hash, Equal, Allocator>& hashTable) {
+    typedef typename std::unordered_map<Key, Value, Hash, Equal, Allocator>::value_type ValueType;
+
+    return hashTable.size() * (sizeof(void*) + sizeof(size_t) + sizeof(ValueType)) + hashTable.bucket_count() * sizeof(void*);
+}
+
+/**
+ * @brief MemoryUsage::vectorBytes returns the number of bytes allocated by a vector, which depends on its capacity.
+ * @param vector is the vector.
+ * @return the number of bytes allocated by the vector.
+ */
+template <class T, class Allocator>
+size_t MemoryUsage::vectorBytes(const std::vector<T, Allocator>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+
+#endif // MEMORY_USAGE_H
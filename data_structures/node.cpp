@@ -6,16 +6,41 @@
  * @param object is the index in the vector in which it is stored.
  */
 Node::Node(const Type& type, const size_t& object) :
-    type(type), object(object) {
+    typeAndObject((static_cast<size_t>(type) << TYPE_SHIFT) | (object & OBJECT_MASK)),
+    leftChild(std::numeric_limits<size_t>::max()), rightChild(std::numeric_limits<size_t>::max()) {
 
 }
 
+/**
+ * @brief Node::Node is the copy constructor of the class, the children of the node are read after its type and object.
+ * @param other is the node to be copied.
+ */
+Node::Node(const Node& other) :
+    typeAndObject(other.typeAndObject.load(std::memory_order_acquire)),
+    leftChild(other.leftChild.load(std::memory_order_relaxed)), rightChild(other.rightChild.load(std::memory_order_relaxed)) {
+
+}
+
+/**
+ * @brief Node::operator = allows a node to be copied, the children of the node are read after its type and object.
+ * It must not be used on a node which other threads traverse, see replace.
+ * @param other is the node to be copied.
+ * @return this node.
+ */
+Node& Node::operator=(const Node& other) {
+    typeAndObject.store(other.typeAndObject.load(std::memory_order_acquire), std::memory_order_relaxed);
+    leftChild.store(other.leftChild.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    rightChild.store(other.rightChild.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    return *this;
+}
+
 /**
  * @brief Node::getType returns the type of the object being stored.
  * @return the type of the object being stored.
  */
 Node::Type Node::getType() const {
-    return type;
+    return static_cast<Type>(typeAndObject.load(std::memory_order_acquire) >> TYPE_SHIFT);
 }
 
 /**
@@ -23,7 +48,7 @@ Node::Type Node::getType() const {
  * @return the index in the vector in which it is stored.
  */
 size_t Node::getObject() const {
-    return object;
+    return typeAndObject.load(std::memory_order_acquire) & OBJECT_MASK;
 }
 
 /**
@@ -31,7 +56,7 @@ size_t Node::getObject() const {
  * @return the index in the vector "nodes" in which it is stored or a specific value which represents null.
  */
 size_t Node::getLeftChild() const {
-    return leftChild;
+    return leftChild.load(std::memory_order_relaxed);
 }
 
 /**
@@ -39,7 +64,7 @@ size_t Node::getLeftChild() const {
  * @return the index in the vector "nodes" in which it is stored or a specific value which represents null.
  */
 size_t Node::getRightChild() const {
-    return rightChild;
+    return rightChild.load(std::memory_order_relaxed);
 }
 
 /**
@@ -47,7 +72,7 @@ size_t Node::getRightChild() const {
  * @param type is the type of the object being stored.
  */
 void Node::setType(const Type& type) {
-    this->type = type;
+    typeAndObject.store((static_cast<size_t>(type) << TYPE_SHIFT) | getObject(), std::memory_order_relaxed);
 }
 
 /**
@@ -55,7 +80,7 @@ void Node::setType(const Type& type) {
  * @param object is the index in the vector in which it is stored.
  */
 void Node::setObject(const size_t& object) {
-    this->object = object;
+    typeAndObject.store((static_cast<size_t>(getType()) << TYPE_SHIFT) | (object & OBJECT_MASK), std::memory_order_relaxed);
 }
 
 /**
@@ -63,7 +88,7 @@ void Node::setObject(const size_t& object) {
  * @param leftChild is the index in the vector "nodes" in which it is stored or a specific value which represents null.
  */
 void Node::setLeftChild(const size_t& leftChild) {
-    this->leftChild = leftChild;
+    this->leftChild.store(leftChild, std::memory_order_relaxed);
 }
 
 /**
@@ -71,5 +96,17 @@ void Node::setLeftChild(const size_t& leftChild) {
  * @param rightChild is the index in the vector "nodes" in which it is store or a specific value which represents null.
  */
 void Node::setRightChild(const size_t& rightChild) {
-    this->rightChild = rightChild;
+    this->rightChild.store(rightChild, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Node::replace allows the node to be replaced by another one while other threads traverse it.
+ * The children are stored first, then the type and the object are released together: a thread which reads the new type
+ * also reads the new children, while a thread which reads the old type does not read the children of a trapezoid node.
+ * @param node is the node which replaces this one.
+ */
+void Node::replace(const Node& node) {
+    leftChild.store(node.getLeftChild(), std::memory_order_relaxed);
+    rightChild.store(node.getRightChild(), std::memory_order_relaxed);
+    typeAndObject.store(node.typeAndObject.load(std::memory_order_relaxed), std::memory_order_release);
 }
@@ -1,6 +1,7 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include <atomic>
 #include <cstddef>
 #include <limits>
 
@@ -10,6 +11,7 @@
  * - an object type such as "POINT", "SEGMENT", "TRAPEZOID";
  * - a leftChild and a rightChild as indexes in the vector "nodes" in which they are stored.
  * std::numeric_limits<size_t>::max() represents null.
+ * The type and the object are stored in the same atomic word, so a node can be replaced while other threads traverse it.
  */
 class Node {
 
@@ -17,6 +19,9 @@ public:
     typedef enum {POINT, SEGMENT, TRAPEZOID} Type;
 
     Node(const Type& type, const size_t& object);
+    Node(const Node& other);
+
+    Node& operator=(const Node& other);
 
     Type getType() const;
     size_t getObject() const;
@@ -30,12 +35,16 @@ public:
     void setLeftChild(const size_t& leftChild);
     void setRightChild(const size_t& rightChild);
 
+    void replace(const Node& node);
+
 private:
-    Type type;
-    size_t object;
+    static const size_t TYPE_SHIFT = std::numeric_limits<size_t>::digits - 2;
+    static const size_t OBJECT_MASK = (size_t(1) << TYPE_SHIFT) - 1;
+
+    std::atomic<size_t> typeAndObject;
 
-    size_t leftChild = std::numeric_limits<size_t>::max();
-    size_t rightChild = std::numeric_limits<size_t>::max();
+    std::atomic<size_t> leftChild;
+    std::atomic<size_t> rightChild;
 
 };
 
@@ -0,0 +1,120 @@
+#include "partitioned_trapezoidalmap.h"
+
+#include <algorithm>
+
+/**
+ * @brief PartitionedTrapezoidalMap::PartitionedTrapezoidalMap is the constructor of the class which creates a single slab as large as the bounding box.
+ * @param boundingBoxMin is the left point of the bounding box.
+ * @param boundingBoxMax is the right point of the bounding box.
+ */
+PartitionedTrapezoidalMap::PartitionedTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax) :
+    boundingBoxMin(boundingBoxMin), boundingBoxMax(boundingBoxMax) {
+    initialize(std::vector<double>());
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::initialize allows to replace the slabs with empty ones separated by the given x coordinates.
+ * @param boundaries are the x coordinates which separate the slabs, sorted and strictly inside the bounding box.
+ */
+void PartitionedTrapezoidalMap::initialize(const std::vector<double>& boundaries) {
+    this->boundaries = boundaries;
+
+    trapezoidalMaps.clear();
+    directedAcyclicGraphs.clear();
+
+    for (size_t slab = 0; slab <= boundaries.size(); slab++) {
+        const cg3::BoundingBox2& slabBoundingBox = getSlabBoundingBox(slab);
+
+        trapezoidalMaps.push_back(TrapezoidalMap(slabBoundingBox.min(), slabBoundingBox.max()));
+        directedAcyclicGraphs.push_back(DirectedAcyclicGraph());
+    }
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::findSlab returns the index of the slab which contains the point.
+ * A point on the boundary between two slabs belongs to the right one.
+ * @param point is the point used to find the slab.
+ * @return the index of the slab which contains the point.
+ */
+size_t PartitionedTrapezoidalMap::findSlab(const cg3::Point2d& point) const {
+    return static_cast<size_t>(std::upper_bound(boundaries.begin(), boundaries.end(), point.x()) - boundaries.begin());
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getSlabNumber returns the number of slabs.
+ * @return the number of slabs.
+ */
+size_t PartitionedTrapezoidalMap::getSlabNumber() const {
+    return trapezoidalMaps.size();
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getBoundaries returns the x coordinates which separate the slabs.
+ * @return the x coordinates which separate the slabs.
+ */
+const std::vector<double>& PartitionedTrapezoidalMap::getBoundaries() const {
+    return boundaries;
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getBoundingBox returns the bounding box which contains all slabs.
+ * @return the bounding box which contains all slabs.
+ */
+cg3::BoundingBox2 PartitionedTrapezoidalMap::getBoundingBox() const {
+    return cg3::BoundingBox2(boundingBoxMin, boundingBoxMax);
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getSlabBoundingBox returns the bounding box of the slab.
+ * @param slab is the slab index.
+ * @return the bounding box of the slab.
+ */
+cg3::BoundingBox2 PartitionedTrapezoidalMap::getSlabBoundingBox(const size_t& slab) const {
+    const double minX = (slab == 0) ? boundingBoxMin.x() : boundaries[slab - 1];
+    const double maxX = (slab == boundaries.size()) ? boundingBoxMax.x() : boundaries[slab];
+
+    return cg3::BoundingBox2(cg3::Point2d(minX, boundingBoxMin.y()), cg3::Point2d(maxX, boundingBoxMax.y()));
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getTrapezoidalMap returns the trapezoidal map of the slab.
+ * @param slab is the slab index.
+ * @return the trapezoidal map of the slab.
+ */
+const TrapezoidalMap& PartitionedTrapezoidalMap::getTrapezoidalMap(const size_t& slab) const {
+    return trapezoidalMaps[slab];
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getTrapezoidalMap returns the trapezoidal map of the slab.
+ * @param slab is the slab index.
+ * @return the trapezoidal map of the slab.
+ */
+TrapezoidalMap& PartitionedTrapezoidalMap::getTrapezoidalMap(const size_t& slab) {
+    return trapezoidalMaps[slab];
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getDirectedAcyclicGraph returns the directed acyclic graph of the slab.
+ * @param slab is the slab index.
+ * @return the directed acyclic graph of the slab.
+ */
+const DirectedAcyclicGraph& PartitionedTrapezoidalMap::getDirectedAcyclicGraph(const size_t& slab) const {
+    return directedAcyclicGraphs[slab];
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::getDirectedAcyclicGraph returns the directed acyclic graph of the slab.
+ * @param slab is the slab index.
+ * @return the directed acyclic graph of the slab.
+ */
+DirectedAcyclicGraph& PartitionedTrapezoidalMap::getDirectedAcyclicGraph(const size_t& slab) {
+    return directedAcyclicGraphs[slab];
+}
+
+/**
+ * @brief PartitionedTrapezoidalMap::clear allows to delete all slabs and to restore a single empty slab.
+ */
+void PartitionedTrapezoidalMap::clear() {
+    initialize(std::vector<double>());
+}
@@ -0,0 +1,48 @@
+#ifndef PARTITIONED_TRAPEZOIDALMAP_H
+#define PARTITIONED_TRAPEZOIDALMAP_H
+
+#include <vector>
+#include "trapezoidalmap.h"
+#include "directed_acyclic_graph.h"
+
+/**
+ * @brief The PartitionedTrapezoidalMap class allows to split the bounding box into vertical slabs, each one with its own trapezoidal map
+ * and directed acyclic graph, so the slabs can be built independently. The slab of a point is found with a binary search over the x
+ * coordinates which separate the slabs.
+ * The slab maps have their own trapezoid indexes, so no point locator uses them and the application builds its map sequentially:
+ * the partitioned map is only available to the library users through algorithms::build and algorithms::query.
+ */
+class PartitionedTrapezoidalMap {
+
+public:
+    PartitionedTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax);
+
+    void initialize(const std::vector<double>& boundaries);
+
+    size_t findSlab(const cg3::Point2d& point) const;
+
+    size_t getSlabNumber() const;
+    const std::vector<double>& getBoundaries() const;
+    cg3::BoundingBox2 getBoundingBox() const;
+    cg3::BoundingBox2 getSlabBoundingBox(const size_t& slab) const;
+
+    const TrapezoidalMap& getTrapezoidalMap(const size_t& slab) const;
+    TrapezoidalMap& getTrapezoidalMap(const size_t& slab);
+
+    const DirectedAcyclicGraph& getDirectedAcyclicGraph(const size_t& slab) const;
+    DirectedAcyclicGraph& getDirectedAcyclicGraph(const size_t& slab);
+
+    void clear();
+
+private:
+    cg3::Point2d boundingBoxMin;
+    cg3::Point2d boundingBoxMax;
+
+    std::vector<double> boundaries;
+
+    std::vector<TrapezoidalMap> trapezoidalMaps;
+    std::vector<DirectedAcyclicGraph> directedAcyclicGraphs;
+
+};
+
+#endif // PARTITIONED_TRAPEZOIDALMAP_H
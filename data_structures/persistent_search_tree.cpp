@@ -0,0 +1,639 @@
+#include "persistent_search_tree.h"
+
+#include <algorithm>
+
+/**
+ * @brief The PersistentSearchTree::SweepTree class is the red-black tree of the segments crossed by the sweep line, in its last version.
+ * Its nodes are the segment indexes, and the nodes whose children change are collected, so that the persistent tree can be updated
+ * at the end of each version.
+ */
+class PersistentSearchTree::SweepTree {
+
+public:
+    SweepTree(const std::vector<Line>& lines);
+
+    void insert(const size_t& segment, const double& x);
+    void erase(const size_t& segment);
+
+    size_t depth(const size_t& segment) const;
+
+    const size_t nil;
+
+    std::vector<size_t> left;
+    std::vector<size_t> right;
+    std::vector<size_t> parent;
+    std::vector<bool> red;
+    std::vector<bool> active;
+    size_t root;
+
+    std::vector<size_t> changedNodes;
+    std::vector<size_t> physicalNodes;
+    std::vector<size_t> queuedVersions;
+
+private:
+    bool below(const size_t& segment, const size_t& other, const double& x) const;
+
+    void setLeft(const size_t& node, const size_t& child);
+    void setRight(const size_t& node, const size_t& child);
+    void rotateLeft(const size_t& node);
+    void rotateRight(const size_t& node);
+    void transplant(const size_t& node, const size_t& other);
+
+    void insertFixup(size_t node);
+    void eraseFixup(size_t node);
+
+    const std::vector<Line>& lines;
+
+};
+
+/**
+ * @brief PersistentSearchTree::SweepTree::SweepTree is the constructor of the class which creates an empty tree, the sentinel nil follows the segment indexes.
+ * @param lines are the lines of the segments.
+ */
+PersistentSearchTree::SweepTree::SweepTree(const std::vector<Line>& lines) :
+    nil(lines.size()),
+    left(lines.size() + 1, lines.size()), right(lines.size() + 1, lines.size()), parent(lines.size() + 1, lines.size()),
+    red(lines.size() + 1, false), active(lines.size(), false), root(lines.size()),
+    physicalNodes(lines.size(), std::numeric_limits<size_t>::max()), queuedVersions(lines.size(), std::numeric_limits<size_t>::max()),
+    lines(lines) {
+
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::insert allows a segment to be inserted, ordered with the other ones at the x coordinate.
+ * @param segment is the segment index.
+ * @param x is the x coordinate where all segments of the tree are compared, inside the x interval of each one.
+ */
+void PersistentSearchTree::SweepTree::insert(const size_t& segment, const double& x) {
+    size_t node = root;
+    size_t nodeParent = nil;
+
+    while (node != nil) {
+        nodeParent = node;
+        node = below(segment, node, x) ? left[node] : right[node];
+    }
+
+    parent[segment] = nodeParent;
+    left[segment] = nil;
+    right[segment] = nil;
+    red[segment] = true;
+    active[segment] = true;
+    changedNodes.push_back(segment);
+
+    if (nodeParent == nil)
+        root = segment;
+    else if (below(segment, nodeParent, x))
+        setLeft(nodeParent, segment);
+    else
+        setRight(nodeParent, segment);
+
+    insertFixup(segment);
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::erase allows a segment to be removed.
+ * @param segment is the segment index.
+ */
+void PersistentSearchTree::SweepTree::erase(const size_t& segment) {
+    size_t moved = segment;
+    bool movedRed = red[moved];
+    size_t node;
+
+    if (left[segment] == nil) {
+        node = right[segment];
+        transplant(segment, right[segment]);
+    }
+    else if (right[segment] == nil) {
+        node = left[segment];
+        transplant(segment, left[segment]);
+    }
+    else {
+        // the successor takes the place of the segment
+        moved = right[segment];
+        while (left[moved] != nil)
+            moved = left[moved];
+
+        movedRed = red[moved];
+        node = right[moved];
+
+        if (parent[moved] == segment) {
+            parent[node] = moved;
+        }
+        else {
+            transplant(moved, right[moved]);
+            setRight(moved, right[segment]);
+            parent[right[moved]] = moved;
+        }
+
+        transplant(segment, moved);
+        setLeft(moved, left[segment]);
+        parent[left[moved]] = moved;
+        red[moved] = red[segment];
+    }
+
+    active[segment] = false;
+
+    if (!movedRed)
+        eraseFixup(node);
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::depth returns the number of ancestors of the segment.
+ * @param segment is the segment index.
+ * @return the number of ancestors of the segment.
+ */
+size_t PersistentSearchTree::SweepTree::depth(const size_t& segment) const {
+    size_t depth = 0;
+
+    for (size_t node = parent[segment]; node != nil; node = parent[node])
+        depth++;
+
+    return depth;
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::below returns whether the segment is below the other one at the x coordinate.
+ * @param segment is the segment index.
+ * @param other is the other segment index.
+ * @param x is the x coordinate where the segments are compared.
+ * @return true if the segment is below the other one, otherwise false.
+ */
+bool PersistentSearchTree::SweepTree::below(const size_t& segment, const size_t& other, const double& x) const {
+    return lines[segment].first * x + lines[segment].second < lines[other].first * x + lines[other].second;
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::setLeft allows to assign the left child of the node, which is collected as changed.
+ * @param node is the node index.
+ * @param child is the new left child.
+ */
+void PersistentSearchTree::SweepTree::setLeft(const size_t& node, const size_t& child) {
+    left[node] = child;
+    changedNodes.push_back(node);
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::setRight allows to assign the right child of the node, which is collected as changed.
+ * @param node is the node index.
+ * @param child is the new right child.
+ */
+void PersistentSearchTree::SweepTree::setRight(const size_t& node, const size_t& child) {
+    right[node] = child;
+    changedNodes.push_back(node);
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::rotateLeft allows the right child of the node to take its place.
+ * @param node is the node index.
+ */
+void PersistentSearchTree::SweepTree::rotateLeft(const size_t& node) {
+    const size_t child = right[node];
+
+    setRight(node, left[child]);
+    if (left[child] != nil)
+        parent[left[child]] = node;
+
+    transplant(node, child);
+    setLeft(child, node);
+    parent[node] = child;
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::rotateRight allows the left child of the node to take its place.
+ * @param node is the node index.
+ */
+void PersistentSearchTree::SweepTree::rotateRight(const size_t& node) {
+    const size_t child = left[node];
+
+    setLeft(node, right[child]);
+    if (right[child] != nil)
+        parent[right[child]] = node;
+
+    transplant(node, child);
+    setRight(child, node);
+    parent[node] = child;
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::transplant allows the other node to take the place of the node under its parent.
+ * @param node is the node index.
+ * @param other is the other node index, it can be nil.
+ */
+void PersistentSearchTree::SweepTree::transplant(const size_t& node, const size_t& other) {
+    if (parent[node] == nil)
+        root = other;
+    else if (node == left[parent[node]])
+        setLeft(parent[node], other);
+    else
+        setRight(parent[node], other);
+
+    parent[other] = parent[node];
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::insertFixup allows the red-black properties to be restored after an insertion.
+ * @param node is the inserted node.
+ */
+void PersistentSearchTree::SweepTree::insertFixup(size_t node) {
+    while (red[parent[node]]) {
+        const size_t grandparent = parent[parent[node]];
+
+        if (parent[node] == left[grandparent]) {
+            const size_t uncle = right[grandparent];
+
+            if (red[uncle]) {
+                red[parent[node]] = false;
+                red[uncle] = false;
+                red[grandparent] = true;
+                node = grandparent;
+            }
+            else {
+                if (node == right[parent[node]]) {
+                    node = parent[node];
+                    rotateLeft(node);
+                }
+
+                red[parent[node]] = false;
+                red[grandparent] = true;
+                rotateRight(grandparent);
+            }
+        }
+        else {
+            const size_t uncle = left[grandparent];
+
+            if (red[uncle]) {
+                red[parent[node]] = false;
+                red[uncle] = false;
+                red[grandparent] = true;
+                node = grandparent;
+            }
+            else {
+                if (node == left[parent[node]]) {
+                    node = parent[node];
+                    rotateRight(node);
+                }
+
+                red[parent[node]] = false;
+                red[grandparent] = true;
+                rotateLeft(grandparent);
+            }
+        }
+    }
+
+    red[root] = false;
+}
+
+/**
+ * @brief PersistentSearchTree::SweepTree::eraseFixup allows the red-black properties to be restored after a removal.
+ * @param node is the node which took the place of the moved one, it can be nil.
+ */
+void PersistentSearchTree::SweepTree::eraseFixup(size_t node) {
+    while (node != root && !red[node]) {
+        if (node == left[parent[node]]) {
+            size_t sibling = right[parent[node]];
+
+            if (red[sibling]) {
+                red[sibling] = false;
+                red[parent[node]] = true;
+                rotateLeft(parent[node]);
+                sibling = right[parent[node]];
+            }
+
+            if (!red[left[sibling]] && !red[right[sibling]]) {
+                red[sibling] = true;
+                node = parent[node];
+            }
+            else {
+                if (!red[right[sibling]]) {
+                    red[left[sibling]] = false;
+                    red[sibling] = true;
+                    rotateRight(sibling);
+                    sibling = right[parent[node]];
+                }
+
+                red[sibling] = red[parent[node]];
+                red[parent[node]] = false;
+                red[right[sibling]] = false;
+                rotateLeft(parent[node]);
+                node = root;
+            }
+        }
+        else {
+            size_t sibling = left[parent[node]];
+
+            if (red[sibling]) {
+                red[sibling] = false;
+                red[parent[node]] = true;
+                rotateRight(parent[node]);
+                sibling = left[parent[node]];
+            }
+
+            if (!red[right[sibling]] && !red[left[sibling]]) {
+                red[sibling] = true;
+                node = parent[node];
+            }
+            else {
+                if (!red[left[sibling]]) {
+                    red[right[sibling]] = false;
+                    red[sibling] = true;
+                    rotateLeft(sibling);
+                    sibling = left[parent[node]];
+                }
+
+                red[sibling] = red[parent[node]];
+                red[parent[node]] = false;
+                red[left[sibling]] = false;
+                rotateRight(parent[node]);
+                node = root;
+            }
+        }
+    }
+
+    red[node] = false;
+}
+
+/**
+ * @brief PersistentSearchTree::PersistentNode::PersistentNode is the constructor of the class which creates a node without the extra child.
+ * @param segment is the segment index.
+ * @param leftChild is the left child, or null.
+ * @param rightChild is the right child, or null.
+ * @param version is the version which creates the node.
+ */
+PersistentSearchTree::PersistentNode::PersistentNode(const size_t& segment, const size_t& leftChild, const size_t& rightChild, const size_t& version) :
+    segment(segment), children{leftChild, rightChild}, version(version),
+    modificationVersion(std::numeric_limits<size_t>::max()), modificationRight(false), modificationChild(std::numeric_limits<size_t>::max()) {
+
+}
+
+/**
+ * @brief PersistentSearchTree::PersistentNode::getChild returns the child of the node in the version.
+ * @param right is true for the right child, false for the left one.
+ * @param version is the version, std::numeric_limits<size_t>::max() for the last one.
+ * @return the child of the node in the version.
+ */
+size_t PersistentSearchTree::PersistentNode::getChild(const bool& right, const size_t& version) const {
+    if (modificationVersion != std::numeric_limits<size_t>::max() && modificationVersion <= version && modificationRight == right)
+        return modificationChild;
+
+    return children[right];
+}
+
+/**
+ * @brief PersistentSearchTree::PersistentSearchTree is the constructor of the class which creates an empty tree.
+ */
+PersistentSearchTree::PersistentSearchTree() {
+
+}
+
+/**
+ * @brief PersistentSearchTree::build allows the persistent tree to be built sweeping the segments of the trapezoidal map.
+ * At each x coordinate the segments which end are removed before the ones which start are inserted, then the changes are stored as a version.
+ * Vertical segments and trapezoids without width are skipped, since a vertical line crosses them in a single point.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ */
+void PersistentSearchTree::build(const TrapezoidalMap& trapezoidalMap) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<TrapezoidalMap::IndexedSegment2d>& indexedSegments = trapezoidalMap.getIndexedSegments();
+    const ChunkedVector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
+    std::vector<std::pair<size_t, size_t>> startingSegments, endingSegments;
+
+    clear();
+
+    // the first two points are the bounding box corners
+    for (size_t i = 2; i < points.size(); i++)
+        xCoordinates.push_back(points[i].x());
+
+    std::sort(xCoordinates.begin(), xCoordinates.end());
+    xCoordinates.erase(std::unique(xCoordinates.begin(), xCoordinates.end()), xCoordinates.end());
+
+    for (size_t segment = 0; segment < indexedSegments.size(); segment++) {
+        const cg3::Point2d& leftPoint = points[indexedSegments[segment].first];
+        const cg3::Point2d& rightPoint = points[indexedSegments[segment].second];
+
+        // a shared geometry store can have segments which are not in the trapezoidal map yet
+        if (leftPoint.x() == rightPoint.x() || !trapezoidalMap.containsSegment(segment)) {
+            lines.push_back(Line(0, 0));
+            continue;
+        }
+
+        const double slope = (rightPoint.y() - leftPoint.y()) / (rightPoint.x() - leftPoint.x());
+        lines.push_back(Line(slope, leftPoint.y() - slope * leftPoint.x()));
+
+        startingSegments.push_back(std::make_pair(static_cast<size_t>(std::lower_bound(xCoordinates.begin(), xCoordinates.end(), leftPoint.x()) - xCoordinates.begin()), segment));
+        endingSegments.push_back(std::make_pair(static_cast<size_t>(std::lower_bound(xCoordinates.begin(), xCoordinates.end(), rightPoint.x()) - xCoordinates.begin()), segment));
+    }
+
+    std::sort(startingSegments.begin(), startingSegments.end());
+    std::sort(endingSegments.begin(), endingSegments.end());
+
+    // sweep the x coordinates, the inserted segments are ordered in the middle of the next slab where all of them are defined
+    SweepTree sweepTree(lines);
+    std::vector<std::pair<size_t, size_t>>::const_iterator startingSegment = startingSegments.begin();
+    std::vector<std::pair<size_t, size_t>>::const_iterator endingSegment = endingSegments.begin();
+
+    for (size_t version = 0; version < xCoordinates.size(); version++) {
+        for (; endingSegment != endingSegments.end() && endingSegment->first == version; endingSegment++)
+            sweepTree.erase(endingSegment->second);
+
+        for (; startingSegment != startingSegments.end() && startingSegment->first == version; startingSegment++)
+            sweepTree.insert(startingSegment->second, (xCoordinates[version] + xCoordinates[version + 1]) / 2);
+
+        store(sweepTree, version);
+    }
+
+    // the trapezoids above each segment (the last key is the bottom side of the bounding box) are ordered by their left x coordinate
+    trapezoidOffsets.assign(indexedSegments.size() + 2, 0);
+
+    for (size_t trapezoid = 0; trapezoid < trapezoids.size(); trapezoid++)
+        if (points[trapezoids[trapezoid].getLeftPoint()].x() < points[trapezoids[trapezoid].getRightPoint()].x())
+            trapezoidOffsets[std::min(trapezoids[trapezoid].getBottomSegment(), indexedSegments.size()) + 1]++;
+
+    for (size_t segment = 0; segment <= indexedSegments.size(); segment++)
+        trapezoidOffsets[segment + 1] += trapezoidOffsets[segment];
+
+    std::vector<size_t> nextTrapezoid(trapezoidOffsets.begin(), trapezoidOffsets.end() - 1);
+    trapezoidsAbove.resize(trapezoidOffsets.back());
+
+    for (size_t trapezoid = 0; trapezoid < trapezoids.size(); trapezoid++)
+        if (points[trapezoids[trapezoid].getLeftPoint()].x() < points[trapezoids[trapezoid].getRightPoint()].x())
+            trapezoidsAbove[nextTrapezoid[std::min(trapezoids[trapezoid].getBottomSegment(), indexedSegments.size())]++] =
+                    std::make_pair(points[trapezoids[trapezoid].getLeftPoint()].x(), trapezoid);
+
+    for (size_t segment = 0; segment <= indexedSegments.size(); segment++)
+        std::sort(trapezoidsAbove.begin() + static_cast<long>(trapezoidOffsets[segment]), trapezoidsAbove.begin() + static_cast<long>(trapezoidOffsets[segment + 1]));
+}
+
+/**
+ * @brief PersistentSearchTree::findBottomSegment returns the segment which is below the point and closest to it.
+ * A point which shares the x coordinate with a point of the map is located in the version of that x coordinate, so as if it were on its right,
+ * or in the previous version if it comes before the points of that x coordinate.
+ * @param point is the point used to find the segment.
+ * @param before is true if the point comes before the points of the map which share its x coordinate.
+ * @return the segment index, or std::numeric_limits<size_t>::max() if the point is above the bottom side of the bounding box only.
+ */
+size_t PersistentSearchTree::findBottomSegment(const cg3::Point2d& point, const bool& before) const {
+    const size_t versions = static_cast<size_t>((before ? std::lower_bound(xCoordinates.begin(), xCoordinates.end(), point.x()) :
+                                                          std::upper_bound(xCoordinates.begin(), xCoordinates.end(), point.x())) - xCoordinates.begin());
+    size_t bottomSegment = std::numeric_limits<size_t>::max();
+
+    if (versions == 0)
+        return bottomSegment;
+
+    const size_t version = versions - 1;
+    size_t node = roots[version];
+
+    while (node != std::numeric_limits<size_t>::max()) {
+        const Line& segmentLine = lines[nodes[node].segment];
+        const bool above = point.y() > segmentLine.first * point.x() + segmentLine.second;
+
+        if (above)
+            bottomSegment = nodes[node].segment;
+
+        node = nodes[node].getChild(above, version);
+    }
+
+    return bottomSegment;
+}
+
+/**
+ * @brief PersistentSearchTree::findTrapezoid returns the trapezoid above the bottom segment which contains the point.
+ * @param bottomSegment is the segment below the point, or std::numeric_limits<size_t>::max() for the bottom side of the bounding box.
+ * @param point is the point used to find the trapezoid.
+ * @param before is true if the point comes before the points of the map which share its x coordinate, so the trapezoids which start
+ * at its x coordinate start after it.
+ * @return the trapezoid index.
+ */
+size_t PersistentSearchTree::findTrapezoid(const size_t& bottomSegment, const cg3::Point2d& point, const bool& before) const {
+    const size_t key = std::min(bottomSegment, lines.size());
+    const std::vector<std::pair<double, size_t>>::const_iterator first = trapezoidsAbove.begin() + static_cast<long>(trapezoidOffsets[key]);
+    const std::vector<std::pair<double, size_t>>::const_iterator last = trapezoidsAbove.begin() + static_cast<long>(trapezoidOffsets[key + 1]);
+
+    // the last trapezoid which starts before the point, the first one if the point is on the left of all of them
+    const std::vector<std::pair<double, size_t>>::const_iterator trapezoid = std::partition_point(first, last, [&point, &before](const std::pair<double, size_t>& trapezoidAbove) {
+        return before ? trapezoidAbove.first < point.x() : trapezoidAbove.first <= point.x();
+    });
+
+    return (trapezoid == first) ? first->second : (trapezoid - 1)->second;
+}
+
+/**
+ * @brief PersistentSearchTree::getVersionNumber returns the number of versions, one for each x coordinate of the points.
+ * @return the number of versions.
+ */
+size_t PersistentSearchTree::getVersionNumber() const {
+    return roots.size();
+}
+
+/**
+ * @brief PersistentSearchTree::getNodeNumber returns the number of persistent nodes, which is O(n).
+ * @return the number of persistent nodes.
+ */
+size_t PersistentSearchTree::getNodeNumber() const {
+    return nodes.size();
+}
+
+/**
+ * @brief PersistentSearchTree::memoryUsage returns the number of bytes allocated by the arrays of the persistent tree.
+ * @return the number of bytes allocated by the persistent tree.
+ */
+size_t PersistentSearchTree::memoryUsage() const {
+    return xCoordinates.capacity() * sizeof(double) + lines.capacity() * sizeof(Line) + nodes.capacity() * sizeof(PersistentNode) +
+           roots.capacity() * sizeof(size_t) + trapezoidOffsets.capacity() * sizeof(size_t) + trapezoidsAbove.capacity() * sizeof(std::pair<double, size_t>);
+}
+
+/**
+ * @brief PersistentSearchTree::clear allows to delete all versions.
+ */
+void PersistentSearchTree::clear() {
+    xCoordinates.clear();
+    lines.clear();
+    nodes.clear();
+    roots.clear();
+    trapezoidOffsets.clear();
+    trapezoidsAbove.clear();
+}
+
+/**
+ * @brief PersistentSearchTree::store allows the changes of the sweep tree to be stored in the persistent tree as the version.
+ * The deepest nodes are stored first, so a node which is copied can update its parent before the parent is stored.
+ * A child which changes is written in place if the node belongs to the version, in the extra child if it is free, otherwise the node is copied.
+ * @param sweepTree is the sweep tree.
+ * @param version is the version.
+ */
+void PersistentSearchTree::store(SweepTree& sweepTree, const size_t& version) {
+    StoreQueue queue;
+
+    for (const size_t& segment : sweepTree.changedNodes) {
+        if (segment != sweepTree.nil && sweepTree.active[segment] && sweepTree.queuedVersions[segment] != version) {
+            sweepTree.queuedVersions[segment] = version;
+            queue.push(std::make_pair(sweepTree.depth(segment), segment));
+        }
+    }
+
+    sweepTree.changedNodes.clear();
+
+    while (!queue.empty()) {
+        const size_t segment = queue.top().second;
+        queue.pop();
+
+        const size_t leftChild = (sweepTree.left[segment] == sweepTree.nil) ? std::numeric_limits<size_t>::max() : sweepTree.physicalNodes[sweepTree.left[segment]];
+        const size_t rightChild = (sweepTree.right[segment] == sweepTree.nil) ? std::numeric_limits<size_t>::max() : sweepTree.physicalNodes[sweepTree.right[segment]];
+        size_t node = sweepTree.physicalNodes[segment];
+
+        // a segment inserted in this version gets its first node
+        if (node == std::numeric_limits<size_t>::max())
+            node = copy(sweepTree, queue, segment, version);
+
+        for (const bool right : {false, true}) {
+            const size_t child = right ? rightChild : leftChild;
+
+            if (nodes[node].getChild(right, std::numeric_limits<size_t>::max()) == child)
+                continue;
+
+            if (nodes[node].version == version) {
+                nodes[node].children[right] = child;
+            }
+            else if (nodes[node].modificationVersion == std::numeric_limits<size_t>::max() ||
+                     (nodes[node].modificationVersion == version && nodes[node].modificationRight == right)) {
+                nodes[node].modificationVersion = version;
+                nodes[node].modificationRight = right;
+                nodes[node].modificationChild = child;
+            }
+            else {
+                node = copy(sweepTree, queue, segment, version);
+                nodes[node].children[right] = child;
+            }
+        }
+    }
+
+    roots.push_back((sweepTree.root == sweepTree.nil) ? std::numeric_limits<size_t>::max() : sweepTree.physicalNodes[sweepTree.root]);
+}
+
+/**
+ * @brief PersistentSearchTree::copy allows a new node of the version to replace the last node of the segment, with the same children.
+ * The parent of the segment in the sweep tree is queued, since it has to point to the new node.
+ * @param sweepTree is the sweep tree.
+ * @param queue contains the nodes of the sweep tree to be stored, the deepest first.
+ * @param segment is the segment index.
+ * @param version is the version.
+ * @return the new node index.
+ */
+size_t PersistentSearchTree::copy(SweepTree& sweepTree, StoreQueue& queue, const size_t& segment, const size_t& version) {
+    const size_t& lastNode = sweepTree.physicalNodes[segment];
+
+    if (lastNode == std::numeric_limits<size_t>::max())
+        nodes.push_back(PersistentNode(segment, std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), version));
+    else
+        nodes.push_back(PersistentNode(segment, nodes[lastNode].getChild(false, std::numeric_limits<size_t>::max()), nodes[lastNode].getChild(true, std::numeric_limits<size_t>::max()), version));
+
+    sweepTree.physicalNodes[segment] = nodes.size() - 1;
+
+    const size_t& parent = sweepTree.parent[segment];
+
+    if (parent != sweepTree.nil && sweepTree.queuedVersions[parent] != version) {
+        sweepTree.queuedVersions[parent] = version;
+        queue.push(std::make_pair(sweepTree.depth(parent), parent));
+    }
+
+    return sweepTree.physicalNodes[segment];
+}
@@ -0,0 +1,73 @@
+#ifndef PERSISTENT_SEARCH_TREE_H
+#define PERSISTENT_SEARCH_TREE_H
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include "trapezoidalmap.h"
+
+/**
+ * @brief The PersistentSearchTree class allows a static trapezoidal map to be queried in O(log n) worst-case time with O(n) space.
+ * A vertical line sweeps the segments from left to right, keeping the segments it crosses in a red-black tree. Each x coordinate of
+ * the points gives a version of the tree, which is made partially persistent with node copying (Sarnak and Tarjan): every node has
+ * one extra child pointer with the version from which it holds, and a node is copied only when it is already used.
+ * A query finds the version of its x coordinate and the segment below it, then the trapezoid above that segment which contains it.
+ */
+class PersistentSearchTree {
+
+public:
+    typedef std::pair<double, double> Line;
+
+    PersistentSearchTree();
+
+    void build(const TrapezoidalMap& trapezoidalMap);
+
+    size_t findBottomSegment(const cg3::Point2d& point, const bool& before) const;
+    size_t findTrapezoid(const size_t& bottomSegment, const cg3::Point2d& point, const bool& before) const;
+
+    size_t getVersionNumber() const;
+    size_t getNodeNumber() const;
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+    /**
+     * @brief The PersistentNode class stores a segment, its two children and the extra child which holds from modificationVersion.
+     * std::numeric_limits<size_t>::max() represents null.
+     */
+    class PersistentNode {
+
+    public:
+        PersistentNode(const size_t& segment, const size_t& leftChild, const size_t& rightChild, const size_t& version);
+
+        size_t getChild(const bool& right, const size_t& version) const;
+
+        size_t segment;
+        size_t children[2];
+        size_t version;
+
+        size_t modificationVersion;
+        bool modificationRight;
+        size_t modificationChild;
+
+    };
+
+    class SweepTree;
+    typedef std::priority_queue<std::pair<size_t, size_t>> StoreQueue;
+
+    void store(SweepTree& sweepTree, const size_t& version);
+    size_t copy(SweepTree& sweepTree, StoreQueue& queue, const size_t& segment, const size_t& version);
+
+    std::vector<double> xCoordinates;
+    std::vector<Line> lines;
+
+    std::vector<PersistentNode> nodes;
+    std::vector<size_t> roots;
+
+    std::vector<size_t> trapezoidOffsets;
+    std::vector<std::pair<double, size_t>> trapezoidsAbove;
+
+};
+
+#endif // PERSISTENT_SEARCH_TREE_H
@@ -0,0 +1,55 @@
+#include "query_packet.h"
+
+const size_t QueryPacket::SIZE;
+
+/**
+ * @brief QueryPacket::QueryPacket is the constructor of the class which creates an empty packet.
+ * @param node is the node of the directed acyclic graph where the points of the packet are.
+ */
+QueryPacket::QueryPacket(const size_t& node) : node(node), size(0) {
+
+}
+
+/**
+ * @brief QueryPacket::isFull returns whether the packet has SIZE points.
+ * @return true if no point can be added to the packet.
+ */
+bool QueryPacket::isFull() const {
+    return size == SIZE;
+}
+
+/**
+ * @brief QueryPacket::add allows a point to be added to the packet, which must not be full.
+ * @param point is the query point.
+ * @param index is the index of the query point in the batch.
+ */
+void QueryPacket::add(const cg3::Point2d& point, const size_t& index) {
+    x[size] = point.x();
+    y[size] = point.y();
+    indexes[size] = index;
+    size++;
+}
+
+/**
+ * @brief QueryPacket::split allows the points of the packet to be divided between the children of its node, keeping their order.
+ * @param leftMask has the bit i set if the point i goes to the left child.
+ * @param leftChild is the left child of the node.
+ * @param rightChild is the right child of the node.
+ * @param leftPacket receives the points which go to the left child.
+ * @param rightPacket receives the points which go to the right child.
+ */
+void QueryPacket::split(const uint64_t& leftMask, const size_t& leftChild, const size_t& rightChild, QueryPacket& leftPacket, QueryPacket& rightPacket) const {
+    leftPacket.node = leftChild;
+    leftPacket.size = 0;
+    rightPacket.node = rightChild;
+    rightPacket.size = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        QueryPacket& packet = (leftMask >> i) & 1 ? leftPacket : rightPacket;
+
+        packet.x[packet.size] = x[i];
+        packet.y[packet.size] = y[i];
+        packet.indexes[packet.size] = indexes[i];
+        packet.size++;
+    }
+}
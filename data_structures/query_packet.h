@@ -0,0 +1,33 @@
+#ifndef QUERY_PACKET_H
+#define QUERY_PACKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cg3/geometry/point2.h>
+
+/**
+ * @brief The QueryPacket class stores up to SIZE query points which are at the same node of the directed acyclic graph, so the node is
+ * read once and compared with all of them. The coordinates are kept in two arrays, so they can be compared a vector at a time.
+ * When the points go to different children the packet is split in two packets, one for each child.
+ */
+class QueryPacket {
+
+public:
+    static const size_t SIZE = 8;
+
+    QueryPacket(const size_t& node = 0);
+
+    bool isFull() const;
+    void add(const cg3::Point2d& point, const size_t& index);
+    void split(const uint64_t& leftMask, const size_t& leftChild, const size_t& rightChild, QueryPacket& leftPacket, QueryPacket& rightPacket) const;
+
+    // node reached by the points, number of points, their coordinates and their indexes in the batch
+    size_t node;
+    size_t size;
+    double x[SIZE];
+    double y[SIZE];
+    size_t indexes[SIZE];
+
+};
+
+#endif // QUERY_PACKET_H
@@ -1,6 +1,7 @@
 #include "segment_intersection_checker.h"
 
 #include <cg3/geometry/intersections2.h>
+#include <cg3/utilities/utils.h>
 
 SegmentIntersectionChecker::SegmentIntersectionChecker()
     : aabbTree(&aabbValueExtractor),
@@ -69,7 +70,31 @@ double SegmentIntersectionChecker::aabbValueExtractor(
 
 bool SegmentIntersectionChecker::checkSegmentIntersection(const cg3::Segment2d& seg1, const cg3::Segment2d& seg2)
 {
-    return cg3::checkSegmentIntersection2(seg1, seg2, true);
+    char code;
+    cg3::checkSegmentIntersection2(seg1, seg2, code);
+
+    //Collinear overlapping segments
+    if (code == 'e')
+        return true;
+
+    //Shared endpoints are allowed, unless the segments overlap from the shared endpoint
+    if (code == 'v') {
+        const cg3::Point2d& shared = (cg3::epsilonEqual(seg1.p1(), seg2.p1()) || cg3::epsilonEqual(seg1.p1(), seg2.p2())) ? seg1.p1() : seg1.p2();
+        const cg3::Point2d v1 = (cg3::epsilonEqual(seg1.p1(), shared) ? seg1.p2() : seg1.p1()) - shared;
+        const cg3::Point2d v2 = (cg3::epsilonEqual(seg2.p1(), shared) ? seg2.p2() : seg2.p1()) - shared;
+
+        return cg3::epsilonEqual(v1.perpendicularDot(v2), 0.0) && v1.dot(v2) > 0;
+    }
+
+    return code == '1';
+}
+
+size_t SegmentIntersectionChecker::memoryUsage()
+{
+    //The tree stores the segments in its leaves, each one with its value allocated apart,
+    //and one internal node for each pair of children
+    const size_t entries = aabbTree.size();
+    return (entries == 0) ? 0 : (2 * entries - 1) * sizeof(AABBTree::Node) + entries * sizeof(cg3::Segment2d);
 }
 
 void SegmentIntersectionChecker::clear()
@@ -31,6 +31,8 @@ public:
     static bool checkSegmentIntersection(
             const cg3::Segment2d& seg1, const cg3::Segment2d& seg2);
 
+    size_t memoryUsage();
+
     void clear();
 
 private:
@@ -0,0 +1,195 @@
+#include "slab_decomposition.h"
+
+#include <algorithm>
+
+/**
+ * @brief SlabDecomposition::SlabDecomposition is the constructor of the class which creates an empty slab decomposition.
+ */
+SlabDecomposition::SlabDecomposition() :
+    minX(0), maxX(0) {
+
+}
+
+/**
+ * @brief SlabDecomposition::build allows the slab decomposition to be built from the segments and the trapezoids of the trapezoidal map.
+ * Vertical segments and trapezoids without width do not cross any slab, so they are skipped.
+ * @param trapezoidalMap contains all points, segments, and trapezoids.
+ */
+void SlabDecomposition::build(const TrapezoidalMap& trapezoidalMap) {
+    const ChunkedVector<cg3::Point2d>& points = trapezoidalMap.getPoints();
+    const ChunkedVector<TrapezoidalMap::IndexedSegment2d>& indexedSegments = trapezoidalMap.getIndexedSegments();
+    const ChunkedVector<Trapezoid>& trapezoids = trapezoidalMap.getTrapezoids();
+
+    clear();
+
+    // the first two points are the bounding box corners
+    minX = points[0].x();
+    maxX = points[1].x();
+
+    for (size_t i = 2; i < points.size(); i++)
+        xCoordinates.push_back(points[i].x());
+
+    std::sort(xCoordinates.begin(), xCoordinates.end());
+    xCoordinates.erase(std::unique(xCoordinates.begin(), xCoordinates.end()), xCoordinates.end());
+
+    const size_t slabNumber = xCoordinates.size() + 1;
+
+    // count the segments which cross each slab, a segment crosses the slabs between its points
+    slabOffsets.assign(slabNumber + 1, 0);
+
+    // a shared geometry store can have segments which are not in the trapezoidal map yet
+    for (size_t segment = 0; segment < indexedSegments.size(); segment++) {
+        if (!trapezoidalMap.containsSegment(segment))
+            continue;
+
+        const TrapezoidalMap::IndexedSegment2d& indexedSegment = indexedSegments[segment];
+        const size_t firstSlab = findSlab(points[indexedSegment.first]);
+        const size_t lastSlab = static_cast<size_t>(std::lower_bound(xCoordinates.begin(), xCoordinates.end(), points[indexedSegment.second].x()) - xCoordinates.begin());
+
+        for (size_t slab = firstSlab; slab <= lastSlab && firstSlab <= lastSlab; slab++)
+            slabOffsets[slab + 1]++;
+    }
+
+    for (size_t slab = 0; slab < slabNumber; slab++)
+        slabOffsets[slab + 1] += slabOffsets[slab];
+
+    // store the segment lines of each slab, ordered from bottom to top at the middle of the slab
+    std::vector<size_t> nextLine(slabOffsets.begin(), slabOffsets.end() - 1);
+    slabLines.resize(slabOffsets.back());
+
+    for (size_t segment = 0; segment < indexedSegments.size(); segment++) {
+        if (!trapezoidalMap.containsSegment(segment))
+            continue;
+
+        const TrapezoidalMap::IndexedSegment2d& indexedSegment = indexedSegments[segment];
+        const size_t firstSlab = findSlab(points[indexedSegment.first]);
+        const size_t lastSlab = static_cast<size_t>(std::lower_bound(xCoordinates.begin(), xCoordinates.end(), points[indexedSegment.second].x()) - xCoordinates.begin());
+        const Line& segmentLine = line(cg3::Segment2d(points[indexedSegment.first], points[indexedSegment.second]));
+
+        for (size_t slab = firstSlab; slab <= lastSlab && firstSlab <= lastSlab; slab++)
+            slabLines[nextLine[slab]++] = segmentLine;
+    }
+
+    for (size_t slab = 0; slab < slabNumber; slab++) {
+        const double x = middleX(slab);
+
+        std::sort(slabLines.begin() + static_cast<long>(slabOffsets[slab]), slabLines.begin() + static_cast<long>(slabOffsets[slab + 1]), [x](const Line& a, const Line& b) {
+            return a.first * x + a.second < b.first * x + b.second;
+        });
+    }
+
+    // every slab has one gap more than its segments, the gap above the bottom segment of a trapezoid refers to it
+    gapTrapezoids.assign(slabOffsets.back() + slabNumber, std::numeric_limits<size_t>::max());
+
+    for (size_t trapezoid = 0; trapezoid < trapezoids.size(); trapezoid++) {
+        const cg3::Point2d& leftPoint = points[trapezoids[trapezoid].getLeftPoint()];
+        const cg3::Point2d& rightPoint = points[trapezoids[trapezoid].getRightPoint()];
+
+        if (leftPoint.x() >= rightPoint.x())
+            continue;
+
+        const size_t firstSlab = findSlab(leftPoint);
+        const size_t lastSlab = static_cast<size_t>(std::lower_bound(xCoordinates.begin(), xCoordinates.end(), rightPoint.x()) - xCoordinates.begin());
+
+        for (size_t slab = firstSlab; slab <= lastSlab; slab++) {
+            size_t gap = 0;
+
+            if (trapezoids[trapezoid].getBottomSegment() != std::numeric_limits<size_t>::max()) {
+                const double x = middleX(slab);
+                const Line& bottomLine = line(trapezoidalMap.getSegment(trapezoids[trapezoid].getBottomSegment()));
+                const double y = bottomLine.first * x + bottomLine.second;
+
+                gap = static_cast<size_t>(std::partition_point(slabLines.begin() + static_cast<long>(slabOffsets[slab]), slabLines.begin() + static_cast<long>(slabOffsets[slab + 1]), [x, y](const Line& segmentLine) {
+                    return segmentLine.first * x + segmentLine.second < y;
+                }) - (slabLines.begin() + static_cast<long>(slabOffsets[slab]))) + 1;
+            }
+
+            gapTrapezoids[slabOffsets[slab] + slab + gap] = trapezoid;
+        }
+    }
+}
+
+/**
+ * @brief SlabDecomposition::findSlab returns the index of the slab which contains the point.
+ * A point which shares the x coordinate with a point of the map belongs to the slab on its right.
+ * @param point is the point used to find the slab.
+ * @return the index of the slab which contains the point.
+ */
+size_t SlabDecomposition::findSlab(const cg3::Point2d& point) const {
+    return static_cast<size_t>(std::upper_bound(xCoordinates.begin(), xCoordinates.end(), point.x()) - xCoordinates.begin());
+}
+
+/**
+ * @brief SlabDecomposition::findGap returns the number of segments of the slab which are below the point, that is the gap which contains it.
+ * @param slab is the slab index.
+ * @param point is the point used to find the gap.
+ * @return the gap index in the slab.
+ */
+size_t SlabDecomposition::findGap(const size_t& slab, const cg3::Point2d& point) const {
+    const std::vector<Line>::const_iterator first = slabLines.begin() + static_cast<long>(slabOffsets[slab]);
+    const std::vector<Line>::const_iterator last = slabLines.begin() + static_cast<long>(slabOffsets[slab + 1]);
+
+    return static_cast<size_t>(std::partition_point(first, last, [&point](const Line& segmentLine) {
+        return segmentLine.first * point.x() + segmentLine.second < point.y();
+    }) - first);
+}
+
+/**
+ * @brief SlabDecomposition::getTrapezoid returns the trapezoid index which contains the gap of the slab.
+ * @param slab is the slab index.
+ * @param gap is the gap index in the slab.
+ * @return the trapezoid index which contains the gap of the slab.
+ */
+size_t SlabDecomposition::getTrapezoid(const size_t& slab, const size_t& gap) const {
+    return gapTrapezoids[slabOffsets[slab] + slab + gap];
+}
+
+/**
+ * @brief SlabDecomposition::getSlabNumber returns the number of slabs.
+ * @return the number of slabs.
+ */
+size_t SlabDecomposition::getSlabNumber() const {
+    return slabOffsets.empty() ? 0 : slabOffsets.size() - 1;
+}
+
+/**
+ * @brief SlabDecomposition::memoryUsage returns the number of bytes allocated by the arrays of the slab decomposition.
+ * @return the number of bytes allocated by the slab decomposition.
+ */
+size_t SlabDecomposition::memoryUsage() const {
+    return xCoordinates.capacity() * sizeof(double) + slabOffsets.capacity() * sizeof(size_t) + slabLines.capacity() * sizeof(Line) +
+           gapTrapezoids.capacity() * sizeof(size_t);
+}
+
+/**
+ * @brief SlabDecomposition::clear allows to delete all slabs.
+ */
+void SlabDecomposition::clear() {
+    xCoordinates.clear();
+    slabOffsets.clear();
+    slabLines.clear();
+    gapTrapezoids.clear();
+}
+
+/**
+ * @brief SlabDecomposition::line returns the slope and the intercept of the line which contains the non-vertical segment.
+ * @param segment is the segment, its first point is the left one.
+ * @return the slope and the intercept of the line which contains the segment.
+ */
+SlabDecomposition::Line SlabDecomposition::line(const cg3::Segment2d& segment) {
+    const double slope = (segment.p2().y() - segment.p1().y()) / (segment.p2().x() - segment.p1().x());
+
+    return Line(slope, segment.p1().y() - slope * segment.p1().x());
+}
+
+/**
+ * @brief SlabDecomposition::middleX returns the x coordinate in the middle of the slab, where the order of its segments is computed.
+ * @param slab is the slab index.
+ * @return the x coordinate in the middle of the slab.
+ */
+double SlabDecomposition::middleX(const size_t& slab) const {
+    const double left = (slab == 0) ? minX : xCoordinates[slab - 1];
+    const double right = (slab == xCoordinates.size()) ? maxX : xCoordinates[slab];
+
+    return (left + right) / 2;
+}
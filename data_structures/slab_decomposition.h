@@ -0,0 +1,49 @@
+#ifndef SLAB_DECOMPOSITION_H
+#define SLAB_DECOMPOSITION_H
+
+#include <vector>
+#include <utility>
+#include "trapezoidalmap.h"
+
+/**
+ * @brief The SlabDecomposition class allows a static trapezoidal map to be queried in O(log n) worst-case time.
+ * The x coordinates of the points split the plane into vertical slabs, and the segments which cross a slab are stored ordered from
+ * bottom to top, so a query is a binary search over the x coordinates followed by a binary search over the segments of the slab.
+ * Every gap between two consecutive segments of a slab refers to the trapezoid of the map which contains it.
+ * All arrays are contiguous, but the size is O(n^2) in the worst case.
+ */
+class SlabDecomposition {
+
+public:
+    typedef std::pair<double, double> Line;
+
+    SlabDecomposition();
+
+    void build(const TrapezoidalMap& trapezoidalMap);
+
+    size_t findSlab(const cg3::Point2d& point) const;
+    size_t findGap(const size_t& slab, const cg3::Point2d& point) const;
+    size_t getTrapezoid(const size_t& slab, const size_t& gap) const;
+
+    size_t getSlabNumber() const;
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+    static Line line(const cg3::Segment2d& segment);
+    double middleX(const size_t& slab) const;
+
+    double minX;
+    double maxX;
+
+    std::vector<double> xCoordinates;
+
+    std::vector<size_t> slabOffsets;
+    std::vector<Line> slabLines;
+
+    std::vector<size_t> gapTrapezoids;
+
+};
+
+#endif // SLAB_DECOMPOSITION_H
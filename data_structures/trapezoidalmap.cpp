@@ -1,102 +1,126 @@
 #include "trapezoidalmap.h"
 
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
 /**
  * @brief TrapezoidalMap::TrapezoidalMap is the constructor of the class which initializes its vectors to the starting situation.
+ * Points and segments are stored in a geometry store owned by the trapezoidal map, everything is allocated from the default memory resource.
  * @param boundingBoxMin is the left point of the bounding box trapezoid.
  * @param boundingBoxMax is the right point of the boundin box trapezoid.
  */
 TrapezoidalMap::TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax) :
-    boundingBox(cg3::Point2d(0,0), cg3::Point2d(0,0)) {
-    initialize(boundingBoxMin, boundingBoxMax);
+    TrapezoidalMap(boundingBoxMin, boundingBoxMax, std::pmr::get_default_resource()) {
+
 }
 
 /**
- * @brief TrapezoidalMap::addPoint allows the new point to be stored if it is not in the vector "points" and returns its position.
- * @param point is the new point.
- * @return the point position in the vector "points".
+ * @brief TrapezoidalMap::TrapezoidalMap is the constructor of the class which initializes its vectors to the starting situation,
+ * keeping points and segments in a geometry store shared with other data structures. The corners of the bounding box trapezoid are
+ * stored as its first two points, so the store must be empty or have the same corners.
+ * @param boundingBoxMin is the left point of the bounding box trapezoid.
+ * @param boundingBoxMax is the right point of the boundin box trapezoid.
+ * @param geometryStore is the shared geometry store.
  */
-size_t TrapezoidalMap::addPoint(const cg3::Point2d& point) {
-    bool found;
-    size_t id = findPoint(point, found);
+TrapezoidalMap::TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, const std::shared_ptr<GeometryStore>& geometryStore) :
+    TrapezoidalMap(boundingBoxMin, boundingBoxMax, geometryStore, std::pmr::get_default_resource()) {
 
-    bool generalPosition = true;
-    if (xCoordSet.find(point.x()) != xCoordSet.end())
-        generalPosition = false;
+}
 
+/**
+ * @brief TrapezoidalMap::TrapezoidalMap is the constructor of the class which initializes its vectors to the starting situation.
+ * Points and segments are stored in a geometry store owned by the trapezoidal map, which is allocated with its containers from the memory resource.
+ * @param boundingBoxMin is the left point of the bounding box trapezoid.
+ * @param boundingBoxMax is the right point of the boundin box trapezoid.
+ * @param memoryResource is the memory resource which allocates the containers of the trapezoidal map, it must outlive the trapezoidal map.
+ */
+TrapezoidalMap::TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, std::pmr::memory_resource* memoryResource) :
+    geometryStore(std::allocate_shared<GeometryStore>(std::pmr::polymorphic_allocator<GeometryStore>(memoryResource), memoryResource)), sharedGeometryStore(false),
+    containedSegments(memoryResource), segmentNumber(0), boundingBox(boundingBoxMin, boundingBoxMax), trapezoids(memoryResource), updateNumber(0) {
+    geometryStore->setCorners(boundingBoxMin, boundingBoxMax);
+    initialize();
+}
 
-    //Point will be inserted
-    if (!found && generalPosition) {
-        id = points.size();
+/**
+ * @brief TrapezoidalMap::TrapezoidalMap is the constructor of the class which initializes its vectors to the starting situation,
+ * keeping points and segments in a geometry store shared with other data structures, which has its own memory resource.
+ * @param boundingBoxMin is the left point of the bounding box trapezoid.
+ * @param boundingBoxMax is the right point of the boundin box trapezoid.
+ * @param geometryStore is the shared geometry store.
+ * @param memoryResource is the memory resource which allocates the trapezoids and the flags of the contained segments, it must outlive the trapezoidal map.
+ */
+TrapezoidalMap::TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, const std::shared_ptr<GeometryStore>& geometryStore, std::pmr::memory_resource* memoryResource) :
+    geometryStore(geometryStore), sharedGeometryStore(true), containedSegments(memoryResource), segmentNumber(0), boundingBox(boundingBoxMin, boundingBoxMax),
+    trapezoids(memoryResource), updateNumber(0) {
+    if (geometryStore->getCornerNumber() == 0)
+        geometryStore->setCorners(boundingBoxMin, boundingBoxMax);
 
-        //Add point
-        points.push_back(point);
+    assert(geometryStore->getPoint(0) == boundingBoxMin && geometryStore->getPoint(1) == boundingBoxMax);
 
-        pointMap.insert(std::make_pair(point, id));
-        xCoordSet.insert(point.x());
+    initialize();
+}
 
-        //Update bounding box
-        boundingBox.setMax(cg3::Point2d(
-                std::max(point.x(), boundingBox.max().x()),
-                std::max(point.y(), boundingBox.max().y())));
-        boundingBox.setMin(cg3::Point2d(
-                std::min(point.x(), boundingBox.min().x()),
-                std::min(point.y(), boundingBox.min().y())));
-    }
+/**
+ * @brief TrapezoidalMap::TrapezoidalMap is the copy constructor of the class: an owned geometry store is copied, a shared one stays shared.
+ * @param other is the trapezoidal map to be copied.
+ */
+TrapezoidalMap::TrapezoidalMap(const TrapezoidalMap& other) :
+    geometryStore(other.sharedGeometryStore ? other.geometryStore : std::make_shared<GeometryStore>(*other.geometryStore)),
+    sharedGeometryStore(other.sharedGeometryStore), containedSegments(other.containedSegments), segmentNumber(other.segmentNumber),
+    boundingBox(other.boundingBox), trapezoids(other.trapezoids), updateNumber(other.updateNumber), updatedTrapezoids(other.updatedTrapezoids) {
 
-    return id;
 }
 
 /**
- * @brief TrapezoidalMap::addSegment allows the new segment to be stored.
- * @param segment is the new segment.
- * @return the indexed segment position in the vector "indexedSegments".
+ * @brief TrapezoidalMap::operator= allows the trapezoidal map to be copied: an owned geometry store is copied, a shared one stays shared.
+ * @param other is the trapezoidal map to be copied.
+ * @return this trapezoidal map.
  */
-size_t TrapezoidalMap::addSegment(const cg3::Segment2d& segment) {
-    size_t id;
-
-    cg3::Segment2d orderedSegment = segment;
-    if (segment.p2() < segment.p1()) {
-        orderedSegment.setP1(segment.p2());
-        orderedSegment.setP2(segment.p1());
+TrapezoidalMap& TrapezoidalMap::operator=(const TrapezoidalMap& other) {
+    if (this != &other) {
+        geometryStore = other.sharedGeometryStore ? other.geometryStore : std::make_shared<GeometryStore>(*other.geometryStore);
+        sharedGeometryStore = other.sharedGeometryStore;
+        containedSegments = other.containedSegments;
+        segmentNumber = other.segmentNumber;
+        boundingBox = other.boundingBox;
+        trapezoids = other.trapezoids;
+        updateNumber = other.updateNumber;
+        updatedTrapezoids = other.updatedTrapezoids;
     }
 
-    bool found;
-    findSegment(orderedSegment, found);
-
-    bool degenerate = orderedSegment.p1() == orderedSegment.p2();
-
-    id = std::numeric_limits<size_t>::max();
-
-    if (!degenerate && !found) {
-        bool generalPosition = true;
-
-        bool foundPoint1;
-        size_t id1 = findPoint(orderedSegment.p1(), foundPoint1);
-        bool foundPoint2;
-        size_t id2 = findPoint(orderedSegment.p2(), foundPoint2);
-
-        if (!foundPoint1 && xCoordSet.find(orderedSegment.p1().x()) != xCoordSet.end())
-            generalPosition = false;
-
-        if (!foundPoint2 && xCoordSet.find(orderedSegment.p2().x()) != xCoordSet.end())
-            generalPosition = false;
-
-        if (generalPosition) {
-            id = indexedSegments.size();
+    return *this;
+}
 
-            if (!foundPoint1)
-                id1 = addPoint(orderedSegment.p1());
+/**
+ * @brief TrapezoidalMap::addPoint allows the new point to be stored if it is not in the vector "points" and returns its position.
+ * @param point is the new point.
+ * @return the point position in the vector "points".
+ */
+size_t TrapezoidalMap::addPoint(const cg3::Point2d& point) {
+    bool pointInserted;
+    return geometryStore->addPoint(point, pointInserted);
+}
 
-            if (!foundPoint2)
-                id2 = addPoint(orderedSegment.p2());
+/**
+ * @brief TrapezoidalMap::addSegment allows the new segment to be stored and added to the trapezoidal map.
+ * A segment already stored in a shared geometry store, for instance by the dataset, is added without being stored again.
+ * @param segment is the new segment.
+ * @return the indexed segment position in the vector "indexedSegments", or null if it is degenerate or already in the trapezoidal map.
+ */
+size_t TrapezoidalMap::addSegment(const cg3::Segment2d& segment) {
+    // points sharing the x coordinate are accepted, they are ordered lexicographically as in a sheared plane
+    bool segmentInserted;
+    const size_t id = geometryStore->addSegment(segment, segmentInserted);
 
-            IndexedSegment2d indexedSegment(id1, id2);
+    if (id == std::numeric_limits<size_t>::max() || containsSegment(id))
+        return std::numeric_limits<size_t>::max();
 
-            indexedSegments.push_back(indexedSegment);
+    while (containedSegments.size() <= id)
+        containedSegments.push_back(false);
 
-            segmentMap.insert(std::make_pair(indexedSegment, id));
-        }
-    }
+    containedSegments[id] = true;
+    segmentNumber++;
 
     return id;
 }
@@ -107,19 +131,8 @@ size_t TrapezoidalMap::addSegment(const cg3::Segment2d& segment) {
  * @param found is a boolean variable.
  * @return the point position in the vector "points" if it is stored or null.
  */
-size_t TrapezoidalMap::findPoint(const cg3::Point2d &point, bool &found) {
-    std::unordered_map<cg3::Point2d, size_t>::iterator it = pointMap.find(point);
-
-    //Point already in the data structure
-    if (it != pointMap.end()) {
-        found = true;
-        return it->second;
-    }
-    //Point not in the data structure
-    else {
-        found = false;
-        return std::numeric_limits<size_t>::max();
-    }
+size_t TrapezoidalMap::findPoint(const cg3::Point2d &point, bool &found) const {
+    return geometryStore->findPoint(point, found);
 }
 
 /**
@@ -128,26 +141,8 @@ size_t TrapezoidalMap::findPoint(const cg3::Point2d &point, bool &found) {
  * @param found is a boolean variable.
  * @return the indexed segment position in the vector "indexedSegments" if it is stored or null.
  */
-size_t TrapezoidalMap::findSegment(const cg3::Segment2d& segment, bool& found) {
-    found = false;
-
-    cg3::Segment2d orderedSegment = segment;
-    if (segment.p2() < segment.p1()) {
-        orderedSegment.setP1(segment.p2());
-        orderedSegment.setP2(segment.p1());
-    }
-
-    bool foundPoint1;
-    size_t id1 = findPoint(orderedSegment.p1(), foundPoint1);
-    if (!foundPoint1)
-        return std::numeric_limits<size_t>::max();
-
-    bool foundPoint2;
-    size_t id2 = findPoint(orderedSegment.p2(), foundPoint2);
-    if (!foundPoint2)
-        return std::numeric_limits<size_t>::max();
-
-    return findIndexedSegment(IndexedSegment2d(id1, id2), found);
+size_t TrapezoidalMap::findSegment(const cg3::Segment2d& segment, bool& found) const {
+    return geometryStore->findSegment(segment, found);
 }
 
 /**
@@ -156,33 +151,16 @@ size_t TrapezoidalMap::findSegment(const cg3::Segment2d& segment, bool& found) {
  * @param found is a boolean variable.
  * @return the indexed segment position in the vector "indexedSegments" if it is stored or null.
  */
-size_t TrapezoidalMap::findIndexedSegment(const IndexedSegment2d& indexedSegment, bool& found) {
-    IndexedSegment2d orderedIndexedSegment = indexedSegment;
-    if (indexedSegment.second < indexedSegment.first) {
-        orderedIndexedSegment.first = indexedSegment.second;
-        orderedIndexedSegment.second = indexedSegment.first;
-    }
-
-    std::unordered_map<IndexedSegment2d, size_t>::iterator it = segmentMap.find(orderedIndexedSegment);
-
-    //Segment already in the data structure
-    if (it != segmentMap.end()) {
-        found = true;
-        return it->second;
-    }
-    //Segment not in the data structure
-    else {
-        found = false;
-        return std::numeric_limits<size_t>::max();
-    }
+size_t TrapezoidalMap::findIndexedSegment(const IndexedSegment2d& indexedSegment, bool& found) const {
+    return geometryStore->findIndexedSegment(indexedSegment, found);
 }
 
 /**
  * @brief TrapezoidalMap::getPoints returns the vector "points".
  * @return the vector "points".
  */
-const std::vector<cg3::Point2d>& TrapezoidalMap::getPoints() const {
-    return points;
+const ChunkedVector<cg3::Point2d>& TrapezoidalMap::getPoints() const {
+    return geometryStore->getPoints();
 }
 
 /**
@@ -191,7 +169,7 @@ const std::vector<cg3::Point2d>& TrapezoidalMap::getPoints() const {
  * @return the point in the vector "points" in the position "id".
  */
 const cg3::Point2d& TrapezoidalMap::getPoint(const size_t& id) const {
-    return points[id];
+    return geometryStore->getPoint(id);
 }
 
 /**
@@ -200,7 +178,16 @@ const cg3::Point2d& TrapezoidalMap::getPoint(const size_t& id) const {
  * @return the Segment object with the points of the indexed segment in the vector "indexedSegments" in the position "id".
  */
 cg3::Segment2d TrapezoidalMap::getSegment(const size_t& id) const {
-    return cg3::Segment2d(points[indexedSegments[id].first], points[indexedSegments[id].second]);
+    return geometryStore->getSegment(id);
+}
+
+/**
+ * @brief TrapezoidalMap::getIndexedSegments returns the vector "indexedSegments" of the geometry store, which can have segments
+ * not contained in the trapezoidal map when the store is shared.
+ * @return the vector "indexedSegments".
+ */
+const ChunkedVector<TrapezoidalMap::IndexedSegment2d>& TrapezoidalMap::getIndexedSegments() const {
+    return geometryStore->getIndexedSegments();
 }
 
 /**
@@ -209,7 +196,32 @@ cg3::Segment2d TrapezoidalMap::getSegment(const size_t& id) const {
  * @return the indexed segment in the vector "indexedSegments" in the position "id".
  */
 const TrapezoidalMap::IndexedSegment2d& TrapezoidalMap::getIndexedSegment(const size_t& id) const {
-    return indexedSegments[id];
+    return geometryStore->getIndexedSegment(id);
+}
+
+/**
+ * @brief TrapezoidalMap::containsSegment returns whether the segment of the geometry store has been added to the trapezoidal map.
+ * @param id is the indexed segment position in the vector "indexedSegments".
+ * @return true if the segment is in the trapezoidal map, otherwise false.
+ */
+bool TrapezoidalMap::containsSegment(const size_t& id) const {
+    return id < containedSegments.size() && containedSegments[id];
+}
+
+/**
+ * @brief TrapezoidalMap::getSegmentNumber returns the number of segments added to the trapezoidal map.
+ * @return the number of segments added to the trapezoidal map.
+ */
+size_t TrapezoidalMap::getSegmentNumber() const {
+    return segmentNumber;
+}
+
+/**
+ * @brief TrapezoidalMap::getGeometryStore returns the geometry store which keeps points and segments.
+ * @return the geometry store.
+ */
+const std::shared_ptr<GeometryStore>& TrapezoidalMap::getGeometryStore() const {
+    return geometryStore;
 }
 
 /**
@@ -221,22 +233,39 @@ const cg3::BoundingBox2& TrapezoidalMap::getBoundingBox() const {
 }
 
 /**
- * @brief TrapezoidalMap::clear allows to delete all points, segments, and trapezoids and re-initialize the vectors to the starting situation.
+ * @brief TrapezoidalMap::clear allows to delete all segments and trapezoids and re-initialize the vectors to the starting situation.
+ * The points and segments of an owned geometry store are deleted, a shared geometry store is left to its other users.
  */
 void TrapezoidalMap::clear() {
-    const cg3::Point2d& boundingBoxMin = points[0];
-    const cg3::Point2d& boundingBoxMax = points[1];
+    if (!sharedGeometryStore)
+        geometryStore->clear();
 
-    points.clear();
-    indexedSegments.clear();
-    pointMap.clear();
-    segmentMap.clear();
-    xCoordSet.clear();
-    boundingBox.setMin(cg3::Point2d(0,0));
-    boundingBox.setMax(cg3::Point2d(0,0));
+    containedSegments.clear();
+    segmentNumber = 0;
 
     trapezoids.clear();
-    initialize(boundingBoxMin, boundingBoxMax);
+    initialize();
+
+    updateNumber++;
+    updatedTrapezoids.clear();
+}
+
+/**
+ * @brief TrapezoidalMap::swap allows the content of two trapezoidal maps to be exchanged, sharing the chunks instead of copying them.
+ * The swap is an update of both maps which changes all their trapezoids, so their update numbers become larger than both previous ones.
+ * @param other is the trapezoidal map to be exchanged with this one.
+ */
+void TrapezoidalMap::swap(TrapezoidalMap& other) {
+    std::swap(geometryStore, other.geometryStore);
+    std::swap(sharedGeometryStore, other.sharedGeometryStore);
+    containedSegments.swap(other.containedSegments);
+    std::swap(segmentNumber, other.segmentNumber);
+    std::swap(boundingBox, other.boundingBox);
+    trapezoids.swap(other.trapezoids);
+
+    updateNumber = other.updateNumber = std::max(updateNumber, other.updateNumber) + 1;
+    updatedTrapezoids.clear();
+    other.updatedTrapezoids.clear();
 }
 
 /**
@@ -250,6 +279,9 @@ void TrapezoidalMap::clear() {
  * @param leftPointUnshared is a boolean variable which is true when the left point is a new point in the trapezoidal map, otherwise it is false.
  */
 void TrapezoidalMap::update(const size_t& trapezoidToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, const std::vector<size_t>& newTrapezoidNodes, const bool& leftPointUnshared) {
+    updateNumber++;
+    updatedTrapezoids.assign(1, trapezoidToDelete);
+
     // create the new trapezoids
     Trapezoid upperTrapezoid(trapezoids[trapezoidToDelete].getTopSegment(), segment, leftPoint, rightPoint, newTrapezoidNodes[0]);
     Trapezoid lowerTrapezoid(segment, trapezoids[trapezoidToDelete].getBottomSegment(), leftPoint, rightPoint, newTrapezoidNodes[1]);
@@ -275,14 +307,14 @@ void TrapezoidalMap::update(const size_t& trapezoidToDelete, const size_t& leftP
         // if the right point of the segment is not new
         if (newTrapezoidNodes.size() != 4) {
             // update the right neighbours of the trapezoid whose segments do not have the same point
-            if (getIndexedSegment(upperTrapezoid.getTopSegment()).second != getIndexedSegment(upperTrapezoid.getBottomSegment()).second) {
+            if (upperTrapezoid.getTopSegment() == std::numeric_limits<size_t>::max() || getIndexedSegment(upperTrapezoid.getTopSegment()).second != rightPoint) {
                 upperTrapezoid.setUpperRightNeighbour(trapezoids[trapezoidToDelete].getUpperRightNeighbour());
 
                 if (upperTrapezoid.getUpperRightNeighbour() != std::numeric_limits<size_t>::max())
                     trapezoids[upperTrapezoid.getUpperRightNeighbour()].setUpperLeftNeighbour(newTrapezoids[0]);
             }
 
-            if (getIndexedSegment(lowerTrapezoid.getTopSegment()).second != getIndexedSegment(lowerTrapezoid.getBottomSegment()).second) {
+            if (lowerTrapezoid.getBottomSegment() == std::numeric_limits<size_t>::max() || getIndexedSegment(lowerTrapezoid.getBottomSegment()).second != rightPoint) {
                 lowerTrapezoid.setLowerRightNeighbour(trapezoids[trapezoidToDelete].getLowerRightNeighbour());
 
                 if (lowerTrapezoid.getLowerRightNeighbour() != std::numeric_limits<size_t>::max())
@@ -293,14 +325,14 @@ void TrapezoidalMap::update(const size_t& trapezoidToDelete, const size_t& leftP
     // if the left point of the segment is not new
     } else {
         // update the left neighbours of the trapezoid whose segments do not have the same point
-        if (getIndexedSegment(upperTrapezoid.getTopSegment()).first != getIndexedSegment(upperTrapezoid.getBottomSegment()).first) {
+        if (upperTrapezoid.getTopSegment() == std::numeric_limits<size_t>::max() || getIndexedSegment(upperTrapezoid.getTopSegment()).first != leftPoint) {
             upperTrapezoid.setUpperLeftNeighbour(trapezoids[trapezoidToDelete].getUpperLeftNeighbour());
 
             if (upperTrapezoid.getUpperLeftNeighbour() != std::numeric_limits<size_t>::max())
                 trapezoids[upperTrapezoid.getUpperLeftNeighbour()].setUpperRightNeighbour(newTrapezoids[0]);
         }
 
-        if (getIndexedSegment(lowerTrapezoid.getTopSegment()).first != getIndexedSegment(lowerTrapezoid.getBottomSegment()).first) {
+        if (lowerTrapezoid.getBottomSegment() == std::numeric_limits<size_t>::max() || getIndexedSegment(lowerTrapezoid.getBottomSegment()).first != leftPoint) {
             lowerTrapezoid.setLowerLeftNeighbour(trapezoids[trapezoidToDelete].getLowerLeftNeighbour());
 
             if (lowerTrapezoid.getLowerLeftNeighbour() != std::numeric_limits<size_t>::max())
@@ -348,8 +380,12 @@ void TrapezoidalMap::update(const size_t& trapezoidToDelete, const size_t& leftP
  * @param newTrapezoids is the vector which contains the new trapezoids indexes.
  * @param newTrapezoidNodes is the vector which contains the indexes of the new trapezoid nodes.
  * @param above is the vector which contains boolean variables which indicate for each trapezoid to be deleted whether it is above the segment.
+ * @param constructionContext contains the scratch vectors of the update.
  */
-void TrapezoidalMap::update(const std::vector<size_t>& trapezoidsToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, const std::vector<size_t>& newTrapezoidNodes, const std::vector<bool>& above) {
+void TrapezoidalMap::update(const std::vector<size_t>& trapezoidsToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, const std::vector<size_t>& newTrapezoidNodes, const std::vector<bool>& above, ConstructionContext& constructionContext) {
+    updateNumber++;
+    updatedTrapezoids.assign(trapezoidsToDelete.begin(), trapezoidsToDelete.end());
+
     // store the index of the first intersected trapezoid
     const size_t& front = trapezoidsToDelete.front();
 
@@ -362,11 +398,14 @@ void TrapezoidalMap::update(const std::vector<size_t>& trapezoidsToDelete, const
     std::vector<size_t>::const_iterator trapezoidNodeToAssign = newTrapezoidNodes.cbegin();
     std::vector<bool>::const_iterator isAbove = above.cbegin();
 
-    std::vector<size_t> upperLeftNeighboursAbove;
-    std::vector<size_t> lowerLeftNeighboursBelow;
+    std::vector<size_t>& upperLeftNeighboursAbove = constructionContext.upperLeftNeighboursAbove;
+    std::vector<size_t>& lowerLeftNeighboursBelow = constructionContext.lowerLeftNeighboursBelow;
+
+    upperLeftNeighboursAbove.clear();
+    lowerLeftNeighboursBelow.clear();
 
-    size_t leftPointAbove = indexedSegments[segment].first;
-    size_t leftPointBelow = indexedSegments[segment].first;
+    size_t leftPointAbove = getIndexedSegment(segment).first;
+    size_t leftPointBelow = getIndexedSegment(segment).first;
 
     size_t lowerLeftNeighbourAbove = std::numeric_limits<size_t>::max();
     size_t upperLeftNeighbourBelow = std::numeric_limits<size_t>::max();
@@ -581,7 +620,7 @@ void TrapezoidalMap::update(const std::vector<size_t>& trapezoidsToDelete, const
  * @brief TrapezoidalMap::getTrapezoids returns the vector "trapezoids".
  * @return the vector "trapezoids".
  */
-const std::vector<Trapezoid>& TrapezoidalMap::getTrapezoids() const {
+const ChunkedVector<Trapezoid>& TrapezoidalMap::getTrapezoids() const {
     return trapezoids;
 }
 
@@ -604,13 +643,101 @@ Trapezoid& TrapezoidalMap::getTrapezoid(const size_t& id) {
 }
 
 /**
- * @brief TrapezoidalMap::initialize allows to create the default trapezoid which represents the bounding box trapezoid.
- * @param boundingBoxMin is the left point.
- * @param boundingBoxMax is the right point.
+ * @brief TrapezoidalMap::getTopSegment returns the top segment of the trapezoid in the position "trapezoid", or the top side of the bounding box if it is null.
+ * @param trapezoid is the trapezoid position in the vector "trapezoids".
+ * @return the top segment of the trapezoid in the position "trapezoid", or the top side of the bounding box if it is null.
+ */
+cg3::Segment2d TrapezoidalMap::getTopSegment(const size_t& trapezoid) const {
+    if (trapezoids[trapezoid].getTopSegment() == std::numeric_limits<size_t>::max())
+        return cg3::Segment2d(cg3::Point2d(getPoint(0).x(), getPoint(1).y()), getPoint(1));
+
+    return getSegment(trapezoids[trapezoid].getTopSegment());
+}
+
+/**
+ * @brief TrapezoidalMap::getBottomSegment returns the bottom segment of the trapezoid in the position "trapezoid", or the bottom side of the bounding box if it is null.
+ * @param trapezoid is the trapezoid position in the vector "trapezoids".
+ * @return the bottom segment of the trapezoid in the position "trapezoid", or the bottom side of the bounding box if it is null.
+ */
+cg3::Segment2d TrapezoidalMap::getBottomSegment(const size_t& trapezoid) const {
+    if (trapezoids[trapezoid].getBottomSegment() == std::numeric_limits<size_t>::max())
+        return cg3::Segment2d(getPoint(0), cg3::Point2d(getPoint(1).x(), getPoint(0).y()));
+
+    return getSegment(trapezoids[trapezoid].getBottomSegment());
+}
+
+/**
+ * @brief TrapezoidalMap::getUpdateNumber returns the number of updates and clears of the trapezoidal map, which changes whenever its trapezoids change.
+ * @return the number of updates of the trapezoidal map.
+ */
+size_t TrapezoidalMap::getUpdateNumber() const {
+    return updateNumber;
+}
+
+/**
+ * @brief TrapezoidalMap::getUpdatedTrapezoids returns the existing trapezoids whose points or segments have been replaced by the last update,
+ * while the new trapezoids of the update are the last ones. Together they are the only trapezoids whose shape has changed.
+ * @return the indexes of the trapezoids replaced by the last update, which are empty after a clear.
+ */
+const std::vector<size_t>& TrapezoidalMap::getUpdatedTrapezoids() const {
+    return updatedTrapezoids;
+}
+
+/**
+ * @brief TrapezoidalMap::memoryUsage returns the bytes allocated by each container of the trapezoidal map.
+ * A shared geometry store is not reported, since it is reported by the data structure which shares it.
+ * @return the report of the bytes allocated by the trapezoidal map.
+ */
+MemoryUsage TrapezoidalMap::memoryUsage() const {
+    MemoryUsage memoryUsage;
+
+    if (!sharedGeometryStore)
+        memoryUsage.add("geometryStore", geometryStore->memoryUsage());
+
+    memoryUsage.add("containedSegments", containedSegments.memoryUsage());
+    memoryUsage.add("trapezoids", trapezoids.memoryUsage());
+    memoryUsage.setSegmentNumber(segmentNumber);
+
+    return memoryUsage;
+}
+
+/**
+ * @brief TrapezoidalMap::getMemoryResource returns the memory resource which allocates the trapezoids and the flags of the contained segments.
+ * @return the memory resource of the trapezoidal map.
+ */
+std::pmr::memory_resource* TrapezoidalMap::getMemoryResource() const {
+    return trapezoids.getMemoryResource();
+}
+
+/**
+ * @brief TrapezoidalMap::snapshot returns a copy of the trapezoidal map which shares the unchanged points, segments, and trapezoids with it.
+ * The tables used to find duplicate points and segments are not copied, since the snapshot is only read.
+ * @return the copy of the trapezoidal map.
+ */
+TrapezoidalMap TrapezoidalMap::snapshot() const {
+    return TrapezoidalMap(std::make_shared<GeometryStore>(geometryStore->snapshot()), containedSegments, segmentNumber, boundingBox, trapezoids, updateNumber);
+}
+
+/**
+ * @brief TrapezoidalMap::TrapezoidalMap is the constructor of the class used by snapshot, which owns the given snapshot of the geometry store
+ * and shares the given vectors.
+ * @param geometryStore is the snapshot of the geometry store.
+ * @param containedSegments are the flags of the segments in the trapezoidal map to be shared.
+ * @param segmentNumber is the number of segments in the trapezoidal map.
+ * @param boundingBox is the bounding box.
+ * @param trapezoids are the trapezoids to be shared.
+ * @param updateNumber is the number of updates of the trapezoidal map.
+ */
+TrapezoidalMap::TrapezoidalMap(const std::shared_ptr<GeometryStore>& geometryStore, const ChunkedVector<bool>& containedSegments, const size_t& segmentNumber, const cg3::BoundingBox2& boundingBox, const ChunkedVector<Trapezoid>& trapezoids, const size_t& updateNumber) :
+    geometryStore(geometryStore), sharedGeometryStore(false), containedSegments(containedSegments), segmentNumber(segmentNumber), boundingBox(boundingBox), trapezoids(trapezoids), updateNumber(updateNumber) {
+
+}
+
+/**
+ * @brief TrapezoidalMap::initialize allows to create the default trapezoid which represents the bounding box trapezoid, whose corners are
+ * the first two points of the geometry store.
  */
-void TrapezoidalMap::initialize(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax) {
-    const size_t& leftPoint = addPoint(boundingBoxMin);
-    const size_t& rightPoint = addPoint(boundingBoxMax);
-    const Trapezoid boundingBoxTrapezoid(std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), leftPoint, rightPoint, 0);
+void TrapezoidalMap::initialize() {
+    const Trapezoid boundingBoxTrapezoid(std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), 0, 1, 0);
     trapezoids.push_back(boundingBoxTrapezoid);
 }
@@ -1,59 +1,98 @@
 #ifndef TRAPEZOIDALMAP_H
 #define TRAPEZOIDALMAP_H
 
+#include <memory>
+#include <memory_resource>
+
 #include <cg3/geometry/point2.h>
 #include <cg3/geometry/segment2.h>
 #include <cg3/geometry/bounding_box2.h>
 #include "trapezoid.h"
+#include "chunked_vector.h"
+#include "memory_usage.h"
+#include "geometry_store.h"
+#include "construction_context.h"
 
 /**
  * @brief The TrapezoidalMap class allows to store segments, with indexed non-duplicates point, and trapezoids.
+ * Points sharing the x coordinate are allowed: they are ordered lexicographically, which is equivalent to a shear of the plane.
+ * Points and segments are kept in a geometry store, which can be shared with the dataset: then the trapezoidal map contains only the
+ * segments of the store which have been added to it, and segment indexes are the same in both.
+ * Trapezoids, the flags of the contained segments and an owned geometry store are allocated from the memory resource given to the constructor,
+ * so a map built in a dedicated arena is released with it. Copies and snapshots allocate from the default resource.
  */
 class TrapezoidalMap {
 
 public:
-    typedef std::pair<size_t, size_t> IndexedSegment2d;
+    typedef GeometryStore::IndexedSegment2d IndexedSegment2d;
 
     TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax);
+    TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, const std::shared_ptr<GeometryStore>& geometryStore);
+    TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, std::pmr::memory_resource* memoryResource);
+    TrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, const std::shared_ptr<GeometryStore>& geometryStore, std::pmr::memory_resource* memoryResource);
+    TrapezoidalMap(const TrapezoidalMap& other);
+
+    TrapezoidalMap& operator=(const TrapezoidalMap& other);
 
     size_t addPoint(const cg3::Point2d& point);
     size_t addSegment(const cg3::Segment2d& segment);
 
-    size_t findPoint(const cg3::Point2d& point, bool& found);
-    size_t findSegment(const cg3::Segment2d& segment, bool& found);
-    size_t findIndexedSegment(const IndexedSegment2d& indexedSegment, bool& found);
+    size_t findPoint(const cg3::Point2d& point, bool& found) const;
+    size_t findSegment(const cg3::Segment2d& segment, bool& found) const;
+    size_t findIndexedSegment(const IndexedSegment2d& indexedSegment, bool& found) const;
 
-    const std::vector<cg3::Point2d>& getPoints() const;
+    const ChunkedVector<cg3::Point2d>& getPoints() const;
     const cg3::Point2d& getPoint(const size_t& id) const;
 
     cg3::Segment2d getSegment(const size_t& id) const;
 
+    const ChunkedVector<IndexedSegment2d>& getIndexedSegments() const;
     const IndexedSegment2d& getIndexedSegment(const size_t& id) const;
 
+    bool containsSegment(const size_t& id) const;
+    size_t getSegmentNumber() const;
+
+    const std::shared_ptr<GeometryStore>& getGeometryStore() const;
+
     const cg3::BoundingBox2& getBoundingBox() const;
 
     void clear();
+    void swap(TrapezoidalMap& other);
 
     void update(const size_t& trapezoidToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, const std::vector<size_t>& newTrapezoidNodes, const bool& leftPointUnshared);
-    void update(const std::vector<size_t>& trapezoidsToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, const std::vector<size_t>& newTrapezoidNodes, const std::vector<bool>& above);
+    void update(const std::vector<size_t>& trapezoidsToDelete, const size_t& leftPoint, const size_t& rightPoint, const size_t& segment, const std::vector<size_t>& newTrapezoids, const std::vector<size_t>& newTrapezoidNodes, const std::vector<bool>& above, ConstructionContext& constructionContext);
 
-    const std::vector<Trapezoid>& getTrapezoids() const;
+    const ChunkedVector<Trapezoid>& getTrapezoids() const;
     const Trapezoid& getTrapezoid(const size_t& id) const;
     Trapezoid& getTrapezoid(const size_t& id);
 
+    cg3::Segment2d getTopSegment(const size_t& trapezoid) const;
+    cg3::Segment2d getBottomSegment(const size_t& trapezoid) const;
+
+    size_t getUpdateNumber() const;
+    const std::vector<size_t>& getUpdatedTrapezoids() const;
+    MemoryUsage memoryUsage() const;
+    std::pmr::memory_resource* getMemoryResource() const;
+
+    TrapezoidalMap snapshot() const;
+
 private:
-    void initialize(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax);
+    void initialize();
 
-    std::vector<cg3::Point2d> points;
-    std::vector<IndexedSegment2d> indexedSegments;
+    TrapezoidalMap(const std::shared_ptr<GeometryStore>& geometryStore, const ChunkedVector<bool>& containedSegments, const size_t& segmentNumber, const cg3::BoundingBox2& boundingBox, const ChunkedVector<Trapezoid>& trapezoids, const size_t& updateNumber);
 
-    std::unordered_map<cg3::Point2d, size_t> pointMap;
-    std::unordered_map<IndexedSegment2d, size_t> segmentMap;
-    std::unordered_set<double> xCoordSet;
+    std::shared_ptr<GeometryStore> geometryStore;
+    bool sharedGeometryStore;
+
+    ChunkedVector<bool> containedSegments;
+    size_t segmentNumber;
 
     cg3::BoundingBox2 boundingBox;
 
-    std::vector<Trapezoid> trapezoids;
+    ChunkedVector<Trapezoid> trapezoids;
+
+    size_t updateNumber;
+    std::vector<size_t> updatedTrapezoids;
 
 };
 
@@ -1,7 +1,9 @@
 #ifndef TRAPEZOIDALMAP_DATASET_H
 #define TRAPEZOIDALMAP_DATASET_H
 
-#include <unordered_map>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 #include <utility>
 
@@ -10,19 +12,72 @@
 #include <cg3/geometry/bounding_box2.h>
 
 #include "data_structures/segment_intersection_checker.h"
+#include "data_structures/memory_usage.h"
+#include "data_structures/geometry_store.h"
 
 /**
  * @brief This class allows to store segments, with indexed non-duplicates point.
- * Every segment is unique, non-degenerate, with points in general position, and
- * it does not have any intersections with the other segments.
+ * Every segment is unique, non-degenerate, and it does not have any intersections
+ * with the other segments. Points may share the x coordinate and segments may be vertical.
+ * Points and segments are kept in a geometry store, which can be shared with the trapezoidal map:
+ * then its first points are the corners of the bounding box trapezoid, which are not part of the dataset.
+ * The geometry store is allocated from the memory resource given to the constructor, while the tree of the intersection checker
+ * is allocated by cg3 from the default heap.
  */
 class TrapezoidalMapDataset {
 
 public:
 
-    typedef std::pair<size_t, size_t> IndexedSegment2d;
+    typedef GeometryStore::IndexedSegment2d IndexedSegment2d;
+
+    /**
+     * @brief The SegmentView class allows the segments of the dataset to be read without copying them: each segment is built
+     * from its indexed segment and its points when it is accessed, so iterating over the view does not allocate.
+     */
+    class SegmentView
+    {
+
+    public:
+
+        class const_iterator
+        {
+
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef cg3::Segment2d value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const cg3::Segment2d* pointer;
+            typedef cg3::Segment2d reference;
+
+            const_iterator(const GeometryStore* geometryStore, size_t id) : geometryStore(geometryStore), id(id) {}
+
+            cg3::Segment2d operator*() const { return geometryStore->getSegment(id); }
+            const_iterator& operator++() { id++; return *this; }
+            bool operator==(const const_iterator& other) const { return id == other.id; }
+            bool operator!=(const const_iterator& other) const { return id != other.id; }
+
+        private:
+            const GeometryStore* geometryStore;
+            size_t id;
+
+        };
+
+        explicit SegmentView(const GeometryStore& geometryStore) : geometryStore(&geometryStore) {}
+
+        size_t size() const { return geometryStore->getIndexedSegments().size(); }
+        bool empty() const { return size() == 0; }
+        cg3::Segment2d operator[](size_t id) const { return geometryStore->getSegment(id); }
+
+        const_iterator begin() const { return const_iterator(geometryStore, 0); }
+        const_iterator end() const { return const_iterator(geometryStore, size()); }
+
+    private:
+        const GeometryStore* geometryStore;
+
+    };
 
     TrapezoidalMapDataset();
+    explicit TrapezoidalMapDataset(std::pmr::memory_resource* memoryResource);
 
     size_t addPoint(const cg3::Point2d& point, bool& pointInserted);
     size_t addSegment(const cg3::Segment2d& segment, bool& segmentInserted);
@@ -35,31 +90,28 @@ public:
     size_t pointNumber();
     size_t segmentNumber();
 
-    const std::vector<cg3::Point2d>& getPoints() const;
-    cg3::Point2d& getPoint(size_t id);
+    const ChunkedVector<cg3::Point2d>& getPoints() const;
     const cg3::Point2d& getPoint(size_t id) const;
 
     std::vector<cg3::Segment2d> getSegments() const;
+    SegmentView getSegmentView() const;
     cg3::Segment2d getSegment(size_t id) const;
 
-    const std::vector<IndexedSegment2d>& getIndexedSegments() const;
+    const ChunkedVector<IndexedSegment2d>& getIndexedSegments() const;
     const IndexedSegment2d& getIndexedSegment(size_t id) const;
-    IndexedSegment2d& getIndexedSegments(size_t id);
 
     const cg3::BoundingBox2& getBoundingBox() const;
 
-    void clear();
+    const std::shared_ptr<GeometryStore>& getGeometryStore() const;
 
-private:
+    MemoryUsage memoryUsage();
 
-    std::vector<cg3::Point2d> points;
-    std::vector<IndexedSegment2d> indexedSegments;
+    void clear();
+    void swap(TrapezoidalMapDataset& other);
 
-    std::unordered_map<cg3::Point2d, size_t> pointMap;
-    std::unordered_map<IndexedSegment2d, size_t> segmentMap;
-    std::unordered_set<double> xCoordSet;
+private:
 
-    cg3::BoundingBox2 boundingBox;
+    std::shared_ptr<GeometryStore> geometryStore;
 
     SegmentIntersectionChecker intersectionChecker;
 
@@ -0,0 +1,83 @@
+#include "trapezoidalmap_progress.h"
+
+/**
+ * @brief TrapezoidalMapProgress::TrapezoidalMapProgress is the constructor of the class, nothing is published.
+ */
+TrapezoidalMapProgress::TrapezoidalMapProgress() :
+    recordedUpdateNumber(0) {
+
+}
+
+/**
+ * @brief TrapezoidalMapProgress::start allows a new build to be followed, discarding the snapshot which has not been taken.
+ * It is called by the builder before the first update.
+ * @param trapezoidalMap is the trapezoidal map to be built.
+ */
+void TrapezoidalMapProgress::start(const TrapezoidalMap& trapezoidalMap) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    recordedUpdateNumber = trapezoidalMap.getUpdateNumber();
+    recordedTrapezoids.clear();
+
+    snapshot.reset();
+    publishedTrapezoids.clear();
+}
+
+/**
+ * @brief TrapezoidalMapProgress::record allows the trapezoids changed by the last update to be recorded. It is called by the builder after
+ * each insertion: if more updates have happened since the previous call, as when the trapezoidal map is built again, all trapezoids are recorded.
+ * @param trapezoidalMap is the trapezoidal map to be built.
+ */
+void TrapezoidalMapProgress::record(const TrapezoidalMap& trapezoidalMap) {
+    if (trapezoidalMap.getUpdateNumber() == recordedUpdateNumber + 1) {
+        const std::vector<size_t>& updatedTrapezoids = trapezoidalMap.getUpdatedTrapezoids();
+        recordedTrapezoids.insert(recordedTrapezoids.end(), updatedTrapezoids.begin(), updatedTrapezoids.end());
+    }
+    else if (trapezoidalMap.getUpdateNumber() != recordedUpdateNumber) {
+        recordedTrapezoids.clear();
+        for (size_t id = 0; id < trapezoidalMap.getTrapezoids().size(); id++)
+            recordedTrapezoids.push_back(id);
+    }
+
+    recordedUpdateNumber = trapezoidalMap.getUpdateNumber();
+}
+
+/**
+ * @brief TrapezoidalMapProgress::publish allows a snapshot of the trapezoidal map and the trapezoids recorded since the previous publication
+ * to be published. It is called by the builder, which may not wait for the reader.
+ * @param trapezoidalMap is the trapezoidal map to be built.
+ * @param wait is true if the builder waits while the reader is taking a snapshot, otherwise nothing is published.
+ * @return true if the snapshot has been published.
+ */
+bool TrapezoidalMapProgress::publish(const TrapezoidalMap& trapezoidalMap, const bool& wait) {
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+
+    if (wait)
+        lock.lock();
+    else if (!lock.try_lock())
+        return false;
+
+    snapshot = std::make_shared<const TrapezoidalMap>(trapezoidalMap.snapshot());
+    publishedTrapezoids.insert(publishedTrapezoids.end(), recordedTrapezoids.begin(), recordedTrapezoids.end());
+    recordedTrapezoids.clear();
+
+    return true;
+}
+
+/**
+ * @brief TrapezoidalMapProgress::take returns the last published snapshot and the trapezoids changed or added since the snapshot taken before.
+ * It is called by the reader.
+ * @param updatedTrapezoids is the vector which receives the changed trapezoids.
+ * @return the last published snapshot, or nullptr if nothing has been published since the previous call.
+ */
+TrapezoidalMapProgress::SnapshotPointer TrapezoidalMapProgress::take(std::vector<size_t>& updatedTrapezoids) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    SnapshotPointer takenSnapshot;
+    takenSnapshot.swap(snapshot);
+
+    updatedTrapezoids.clear();
+    updatedTrapezoids.swap(publishedTrapezoids);
+
+    return takenSnapshot;
+}
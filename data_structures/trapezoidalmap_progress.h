@@ -0,0 +1,40 @@
+#ifndef TRAPEZOIDALMAP_PROGRESS_H
+#define TRAPEZOIDALMAP_PROGRESS_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "trapezoidalmap.h"
+
+/**
+ * @brief The TrapezoidalMapProgress class allows a trapezoidal map to be shown while another thread builds it.
+ * The builder records the trapezoids changed by each update and periodically publishes a snapshot of the trapezoidal map, which shares
+ * the unchanged trapezoids with it, together with the trapezoids changed since the previous publication. If the reader is taking a snapshot
+ * the builder does not wait and keeps the changed trapezoids for the next publication. The reader takes the last snapshot with all the
+ * trapezoids changed since the snapshot it took before, so it only has to update them and append the new ones.
+ */
+class TrapezoidalMapProgress {
+
+public:
+    typedef std::shared_ptr<const TrapezoidalMap> SnapshotPointer;
+
+    TrapezoidalMapProgress();
+
+    void start(const TrapezoidalMap& trapezoidalMap);
+    void record(const TrapezoidalMap& trapezoidalMap);
+    bool publish(const TrapezoidalMap& trapezoidalMap, const bool& wait);
+
+    SnapshotPointer take(std::vector<size_t>& updatedTrapezoids);
+
+private:
+    size_t recordedUpdateNumber;
+    std::vector<size_t> recordedTrapezoids;
+
+    SnapshotPointer snapshot;
+    std::vector<size_t> publishedTrapezoids;
+
+    std::mutex mutex;
+
+};
+
+#endif // TRAPEZOIDALMAP_PROGRESS_H
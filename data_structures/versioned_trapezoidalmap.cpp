@@ -0,0 +1,100 @@
+#include "versioned_trapezoidalmap.h"
+
+#include <atomic>
+
+/**
+ * @brief VersionedTrapezoidalMap::Version::Version is the constructor of the class which stores the copies of the given data structures.
+ * @param trapezoidalMap is the trapezoidal map to be copied, its unchanged trapezoids are shared.
+ * @param directedAcyclicGraph is the directed acyclic graph to be copied, its unchanged nodes are shared.
+ * @param number is the version number.
+ */
+VersionedTrapezoidalMap::Version::Version(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& number) :
+    trapezoidalMap(trapezoidalMap.snapshot()), directedAcyclicGraph(directedAcyclicGraph), number(number) {
+
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::Version::getTrapezoidalMap returns the trapezoidal map of the version.
+ * @return the trapezoidal map of the version.
+ */
+const TrapezoidalMap& VersionedTrapezoidalMap::Version::getTrapezoidalMap() const {
+    return trapezoidalMap;
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::Version::getDirectedAcyclicGraph returns the directed acyclic graph of the version.
+ * @return the directed acyclic graph of the version.
+ */
+const DirectedAcyclicGraph& VersionedTrapezoidalMap::Version::getDirectedAcyclicGraph() const {
+    return directedAcyclicGraph;
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::Version::getNumber returns the version number, which grows with each publication.
+ * @return the version number.
+ */
+size_t VersionedTrapezoidalMap::Version::getNumber() const {
+    return number;
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::VersionedTrapezoidalMap is the constructor of the class which publishes the version of the empty trapezoidal map.
+ * @param boundingBoxMin is the left point of the bounding box trapezoid.
+ * @param boundingBoxMax is the right point of the boundin box trapezoid.
+ */
+VersionedTrapezoidalMap::VersionedTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax) :
+    trapezoidalMap(boundingBoxMin, boundingBoxMax), versionNumber(0) {
+    publish();
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::pin returns the last published version, which is kept alive until the returned pointer is released.
+ * It can be called by any thread while the writer updates the trapezoidal map.
+ * @return the last published version.
+ */
+VersionedTrapezoidalMap::VersionPointer VersionedTrapezoidalMap::pin() const {
+    return std::atomic_load(&currentVersion);
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::getTrapezoidalMap returns the trapezoidal map of the writer, which is not visible to readers until it is published.
+ * @return the trapezoidal map of the writer.
+ */
+TrapezoidalMap& VersionedTrapezoidalMap::getTrapezoidalMap() {
+    return trapezoidalMap;
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::getDirectedAcyclicGraph returns the directed acyclic graph of the writer, which is not visible to readers until it is published.
+ * @return the directed acyclic graph of the writer.
+ */
+DirectedAcyclicGraph& VersionedTrapezoidalMap::getDirectedAcyclicGraph() {
+    return directedAcyclicGraph;
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::getWriterMutex returns the mutex which must be held while the writer data structures are updated and published.
+ * @return the mutex of the writer.
+ */
+std::mutex& VersionedTrapezoidalMap::getWriterMutex() {
+    return writerMutex;
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::publish allows the writer data structures to be published as a new version.
+ * The previous version is deleted when the last reader which pinned it releases it.
+ */
+void VersionedTrapezoidalMap::publish() {
+    std::atomic_store(&currentVersion, VersionPointer(std::make_shared<const Version>(trapezoidalMap, directedAcyclicGraph, versionNumber++)));
+}
+
+/**
+ * @brief VersionedTrapezoidalMap::clear allows to delete all segments and to publish the version of the empty trapezoidal map.
+ */
+void VersionedTrapezoidalMap::clear() {
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    trapezoidalMap.clear();
+    directedAcyclicGraph.clear();
+    publish();
+}
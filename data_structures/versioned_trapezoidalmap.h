@@ -0,0 +1,62 @@
+#ifndef VERSIONED_TRAPEZOIDALMAP_H
+#define VERSIONED_TRAPEZOIDALMAP_H
+
+#include <memory>
+#include <mutex>
+#include "trapezoidalmap.h"
+#include "directed_acyclic_graph.h"
+
+/**
+ * @brief The VersionedTrapezoidalMap class allows to query a trapezoidal map while segments are added to it.
+ * The writer updates its own trapezoidal map and directed acyclic graph, and publishes them as an immutable version which shares
+ * the unchanged nodes and trapezoids with the previous one. Readers pin a version without locks, and a version is deleted
+ * when the last reader releases it.
+ * The application does not use it yet, it is provided to the library users which query the map from other threads.
+ */
+class VersionedTrapezoidalMap {
+
+public:
+    /**
+     * @brief The Version class stores an immutable copy of the trapezoidal map and of the directed acyclic graph.
+     */
+    class Version {
+
+    public:
+        Version(const TrapezoidalMap& trapezoidalMap, const DirectedAcyclicGraph& directedAcyclicGraph, const size_t& number);
+
+        const TrapezoidalMap& getTrapezoidalMap() const;
+        const DirectedAcyclicGraph& getDirectedAcyclicGraph() const;
+        size_t getNumber() const;
+
+    private:
+        const TrapezoidalMap trapezoidalMap;
+        const DirectedAcyclicGraph directedAcyclicGraph;
+        const size_t number;
+
+    };
+
+    typedef std::shared_ptr<const Version> VersionPointer;
+
+    VersionedTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax);
+
+    VersionPointer pin() const;
+
+    TrapezoidalMap& getTrapezoidalMap();
+    DirectedAcyclicGraph& getDirectedAcyclicGraph();
+    std::mutex& getWriterMutex();
+
+    void publish();
+    void clear();
+
+private:
+    TrapezoidalMap trapezoidalMap;
+    DirectedAcyclicGraph directedAcyclicGraph;
+
+    VersionPointer currentVersion;
+    size_t versionNumber;
+
+    std::mutex writerMutex;
+
+};
+
+#endif // VERSIONED_TRAPEZOIDALMAP_H
@@ -2,69 +2,83 @@
 
 #include <cg3/viewer/opengl_objects/opengl_objects2.h>
 #include "utils/geometric_utils.h"
+#include "data_structures/flat_hash_map.h"
+#include "algorithms/algorithms.h"
+
+// number of trapezoids whose corners are computed together, so their indexes and corners stay in the cache
+#define TRAPEZOID_BLOCK_SIZE 1024
 
 /**
  * @brief DrawableTrapezoidalMap::DrawableTrapezoidalMap is the constructor of the class which initializes the trapezoidal map.
  * @param boundingBoxMin is the left point of the bounding box trapezoid.
  * @param boundingBoxMax is the right point of the bounding box trapezoid.
+ * @param geometryStore is the geometry store shared with the dataset.
  */
-DrawableTrapezoidalMap::DrawableTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax) :
-    TrapezoidalMap(boundingBoxMin, boundingBoxMax) {
-    std::srand(time(nullptr));
+DrawableTrapezoidalMap::DrawableTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, const std::shared_ptr<GeometryStore>& geometryStore) :
+    TrapezoidalMap(boundingBoxMin, boundingBoxMax, geometryStore) {
     initialize();
 }
 
 /**
  * @brief DrawableTrapezoidalMap::draw allows drawing trapezoids and vertical lines and highlighting the query output trapezoid.
+ * The vertex arrays are drawn as they are, so they must have been updated after the last change of the trapezoidal map.
  */
 void DrawableTrapezoidalMap::draw() const {
-    const std::vector<cg3::Point2d>& points = getPoints();
-    const std::vector<Trapezoid>& trapezoids = getTrapezoids();
-
-    // red color to draw vertical lines
-    const cg3::Color verticalLineColor(255, 0, 0);
-
-    // create the top and the bottom segment of the bounding box
-    const cg3::Segment2d boundingBoxTopSegment(cg3::Point2d(points[0].x(), points[1].y()), points[1]);
-    const cg3::Segment2d boundingBoxBottomSegment(points[0], cg3::Point2d(points[1].x(), points[0].y()));
-
-    for (size_t id = 0; id < trapezoids.size(); id++) {
-        // get the top and the bottom segment of the trapezoid to be drawn
-        const cg3::Segment2d& topSegment = (trapezoids[id].getTopSegment() == std::numeric_limits<size_t>::max()) ? boundingBoxTopSegment : getSegment(trapezoids[id].getTopSegment());
-        const cg3::Segment2d& bottomSegment = (trapezoids[id].getBottomSegment() == std::numeric_limits<size_t>::max()) ? boundingBoxBottomSegment : getSegment(trapezoids[id].getBottomSegment());
-
-        // get the points of the trapezoid to be drawn by calculating the intersections
-        const cg3::Point2d& lowerLeftPoint = geometricUtils::intersection(bottomSegment, points[trapezoids[id].getLeftPoint()].x());
-        const cg3::Point2d& upperLeftPoint = geometricUtils::intersection(topSegment, points[trapezoids[id].getLeftPoint()].x());
-        const cg3::Point2d& upperRightPoint = geometricUtils::intersection(topSegment, points[trapezoids[id].getRightPoint()].x());
-        const cg3::Point2d& lowerRightPoint = geometricUtils::intersection(bottomSegment, points[trapezoids[id].getRightPoint()].x());
-
-        // if the left point is not the lower left point of the bounding box
-        if (trapezoids[id].getLeftPoint() != 0)
-            // draw the red vertical line
-            cg3::opengl::drawLine2(lowerLeftPoint, upperLeftPoint, verticalLineColor);
-
-        // if the right point is not the upper right point the bounding box
-        if (trapezoids[id].getRightPoint() != 1)
-            // draw the red vertical line
-            cg3::opengl::drawLine2(lowerRightPoint, upperRightPoint, verticalLineColor);
-
-        glBegin(GL_POLYGON);
-
-        // set the color to use to draw the trapezoid (highlightColor if it is the last trapezoid found)
-        if (lastTrapezoidFound == id)
-            glColor3d(highlightColor.red() / 255.0, highlightColor.green() / 255.0, highlightColor.blue() / 255.0);
-        else
-            glColor3d(trapezoidColors[id].red() / 255.0, trapezoidColors[id].green() / 255.0, trapezoidColors[id].blue() / 255.0);
-
-        // set the vertices of the trapezoid
-        glVertex2d(lowerLeftPoint.x(), lowerLeftPoint.y());
-        glVertex2d(upperLeftPoint.x(), upperLeftPoint.y());
-        glVertex2d(upperRightPoint.x(), upperRightPoint.y());
-        glVertex2d(lowerRightPoint.x(), lowerRightPoint.y());
-
-        glEnd();
+    cg3::BoundingBox2 view;
+    double pixelSize;
+    getView(view, pixelSize);
+
+    // compute the visible trapezoids again if the view is not in the culled window or the level of detail has changed
+    if (culledUpdateNumber != drawnUpdateNumber || !culledWindow.isInside(view.min()) || !culledWindow.isInside(view.max()) ||
+            pixelSize > 2 * culledPixelSize || 2 * pixelSize < culledPixelSize)
+        cull(view, pixelSize);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, vertices.data());
+
+    // draw the bounding box trapezoid gray where the trapezoids are too small, since it is the average of their colors
+    const cg3::Point2d& boundingBoxMin = getPoint(0);
+    const cg3::Point2d& boundingBoxMax = getPoint(1);
+    glColor3d(0.5, 0.5, 0.5);
+    glRectd(boundingBoxMin.x(), boundingBoxMin.y(), boundingBoxMax.x(), boundingBoxMax.y());
+
+    // draw the visible trapezoids with their colors
+    glEnableClientState(GL_COLOR_ARRAY);
+    glColorPointer(3, GL_UNSIGNED_BYTE, 0, vertexColors.data());
+    glDrawElements(GL_QUADS, static_cast<GLsizei>(visibleTrapezoidIndexes.size()), GL_UNSIGNED_INT, visibleTrapezoidIndexes.data());
+    glDisableClientState(GL_COLOR_ARRAY);
+
+    // draw the last trapezoid found again with the highlight color
+    if (lastTrapezoidFound < vertices.size() / 8) {
+        glColor3d(highlightColor.red() / 255.0, highlightColor.green() / 255.0, highlightColor.blue() / 255.0);
+        glDrawArrays(GL_QUADS, static_cast<GLint>(4 * lastTrapezoidFound), 4);
     }
+
+    // draw the red vertical lines between the corners of the trapezoids
+    glLineWidth(3);
+    glColor3d(1, 0, 0);
+    glDrawElements(GL_LINES, static_cast<GLsizei>(visibleVerticalLineIndexes.size()), GL_UNSIGNED_INT, visibleVerticalLineIndexes.data());
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::setDirectedAcyclicGraph allows the directed acyclic graph of the trapezoidal map to be used to find
+ * the trapezoids in a small view with algorithms::windowQuery, instead of going over all trapezoids.
+ * @param directedAcyclicGraph is the directed acyclic graph updated with the trapezoidal map, or nullptr.
+ */
+void DrawableTrapezoidalMap::setDirectedAcyclicGraph(const DirectedAcyclicGraph* directedAcyclicGraph) {
+    this->directedAcyclicGraph = directedAcyclicGraph;
+    culledUpdateNumber = std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::setMinimumPixelSize allows to set the size in pixels below which a trapezoid is not drawn.
+ * @param minimumPixelSize is the minimum width or height of a drawn trapezoid in pixels.
+ */
+void DrawableTrapezoidalMap::setMinimumPixelSize(const double& minimumPixelSize) {
+    this->minimumPixelSize = minimumPixelSize;
+    culledUpdateNumber = std::numeric_limits<size_t>::max();
 }
 
 /**
@@ -92,38 +106,359 @@ void DrawableTrapezoidalMap::highlight(const size_t& lastTrapezoidFound) {
 }
 
 /**
- * @brief DrawableTrapezoidalMap::addTrapezoidColors allows adding new random colors in the vector "trapezoidColors" for the new trapezoids after a new segment insertion.
+ * @brief DrawableTrapezoidalMap::updateVertexArrays allows the vertex arrays to be updated after the trapezoidal map has changed.
+ * After one update only the trapezoids replaced by it and the new ones are computed again, while after a clear or more updates
+ * (as when the point locator rebuilds the trapezoidal map) or after snapshots of another trapezoidal map all trapezoids are computed again.
  */
-void DrawableTrapezoidalMap::addTrapezoidColors() {
-    const size_t& trapezoidNumber = getTrapezoids().size();
-    cg3::Color trapezoidColor;
+void DrawableTrapezoidalMap::updateVertexArrays() {
+    const size_t trapezoidNumber = getTrapezoids().size();
+    size_t firstNewTrapezoid = vertices.size() / 8;
 
-    // if there are not enough colors
-    while (trapezoidColors.size() < trapezoidNumber) {
-        // generate a random color which is different from the highlight color
-        do {
-            trapezoidColor = cg3::Color(std::rand() % 256, std::rand() % 256, std::rand() % 256);
-        } while (trapezoidColor == highlightColor);
+    if (drawingSnapshots) {
+        drawingSnapshots = false;
+        firstNewTrapezoid = 0;
+        culledUpdateNumber = std::numeric_limits<size_t>::max();
+    }
+    else if (getUpdateNumber() == drawnUpdateNumber) {
+        return;
+    }
+    else if (getUpdateNumber() != drawnUpdateNumber + 1 || firstNewTrapezoid > trapezoidNumber) {
+        firstNewTrapezoid = 0;
+    }
+
+    if (firstNewTrapezoid == 0)
+        resetLineCoefficients();
+
+    vertices.resize(8 * trapezoidNumber);
+    vertexColors.resize(12 * trapezoidNumber);
+    verticalLineIndexes.resize(4 * trapezoidNumber);
+
+    updateLineCoefficients(*this);
+
+    if (firstNewTrapezoid > 0)
+        setTrapezoidVertices(*this, getUpdatedTrapezoids(), firstNewTrapezoid);
+
+    setTrapezoidVertices(*this, firstNewTrapezoid, trapezoidNumber);
 
-        // store the new random color
-        trapezoidColors.push_back(trapezoidColor);
+    drawnUpdateNumber = getUpdateNumber();
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::appendSnapshot allows the vertex arrays to show the snapshot of a trapezoidal map built by another thread,
+ * instead of this trapezoidal map. The first snapshot replaces all vertex arrays, then only the trapezoids changed since the previous snapshot
+ * and the new ones are computed. The vertex arrays show this trapezoidal map again after updateVertexArrays or swap.
+ * @param snapshot is the snapshot of the trapezoidal map under construction.
+ * @param updatedTrapezoids are the trapezoids changed since the previous snapshot.
+ */
+void DrawableTrapezoidalMap::appendSnapshot(const TrapezoidalMap& snapshot, const std::vector<size_t>& updatedTrapezoids) {
+    const size_t trapezoidNumber = snapshot.getTrapezoids().size();
+    size_t firstNewTrapezoid = vertices.size() / 8;
+
+    if (!drawingSnapshots) {
+        drawingSnapshots = true;
+        firstNewTrapezoid = 0;
+        lastTrapezoidFound = std::numeric_limits<size_t>::max();
+        resetLineCoefficients();
     }
+
+    firstNewTrapezoid = std::min(firstNewTrapezoid, trapezoidNumber);
+
+    vertices.resize(8 * trapezoidNumber);
+    vertexColors.resize(12 * trapezoidNumber);
+    verticalLineIndexes.resize(4 * trapezoidNumber);
+
+    updateLineCoefficients(snapshot);
+
+    setTrapezoidVertices(snapshot, updatedTrapezoids, firstNewTrapezoid);
+    setTrapezoidVertices(snapshot, firstNewTrapezoid, trapezoidNumber);
+
+    drawnUpdateNumber = snapshot.getUpdateNumber();
+    culledUpdateNumber = std::numeric_limits<size_t>::max();
 }
 
 /**
- * @brief DrawableTrapezoidalMap::clear allows to clear and re-initialize the trapezoidal map and the vector "trapezoidColors".
+ * @brief DrawableTrapezoidalMap::getTrapezoidColor returns the color of the trapezoid, whose channels are three bytes of the hash of its index.
+ * The trapezoid with index 0, which is the bounding box trapezoid before any insertion, is white.
+ * @param id is the index of the trapezoid.
+ * @return the color of the trapezoid, which is different from the highlight color.
+ */
+cg3::Color DrawableTrapezoidalMap::getTrapezoidColor(const size_t& id) const {
+    if (id == 0)
+        return cg3::Color(255, 255, 255);
+
+    const uint64_t hash = HashMixer::mix(static_cast<uint64_t>(id));
+    cg3::Color trapezoidColor(static_cast<int>(hash & 0xff), static_cast<int>((hash >> 8) & 0xff), static_cast<int>((hash >> 16) & 0xff));
+
+    // take other bytes of the hash if they give the highlight color
+    if (trapezoidColor == highlightColor)
+        trapezoidColor = cg3::Color(static_cast<int>((hash >> 24) & 0xff), static_cast<int>((hash >> 32) & 0xff), static_cast<int>((hash >> 40) & 0xff) | 1);
+
+    return trapezoidColor;
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::clear allows to clear and re-initialize the trapezoidal map and the vertex arrays.
  */
 void DrawableTrapezoidalMap::clear() {
     TrapezoidalMap::clear();
-    trapezoidColors.clear();
     initialize();
 }
 
 /**
- * @brief DrawableTrapezoidalMap::initialize allows to initialize the vector "trapezoidColors" and set the index of the last trapezoid found to null.
+ * @brief DrawableTrapezoidalMap::swap allows the trapezoidal map to be exchanged with another one, as one built on another thread.
+ * If the vertex arrays show the last snapshot of the other trapezoidal map they are kept, otherwise the swapped trapezoids are not an update
+ * of the drawn ones and all vertex arrays are computed again. No trapezoid is highlighted.
+ * @param other is the trapezoidal map to be exchanged with this one.
+ */
+void DrawableTrapezoidalMap::swap(TrapezoidalMap& other) {
+    const bool otherDrawn = drawingSnapshots && drawnUpdateNumber == other.getUpdateNumber() && vertices.size() / 8 == other.getTrapezoids().size();
+
+    TrapezoidalMap::swap(other);
+
+    lastTrapezoidFound = std::numeric_limits<size_t>::max();
+
+    if (otherDrawn) {
+        drawingSnapshots = false;
+        drawnUpdateNumber = getUpdateNumber();
+        culledUpdateNumber = std::numeric_limits<size_t>::max();
+    }
+    else {
+        drawnUpdateNumber = std::numeric_limits<size_t>::max();
+        updateVertexArrays();
+    }
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::initialize allows to initialize the vertex arrays with the bounding box trapezoid and set the index of the last trapezoid found to null.
  */
 void DrawableTrapezoidalMap::initialize() {
-    const cg3::Color boundingBoxColor(255, 255, 255);
-    trapezoidColors.push_back(boundingBoxColor);
     lastTrapezoidFound = std::numeric_limits<size_t>::max();
+
+    vertices.assign(8, 0);
+    vertexColors.assign(12, 0);
+    verticalLineIndexes.assign(4, 0);
+    resetLineCoefficients();
+    updateLineCoefficients(*this);
+    setTrapezoidVertices(*this, 0, 1);
+    drawnUpdateNumber = getUpdateNumber();
+    drawingSnapshots = false;
+    culledUpdateNumber = std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::getView computes the rectangle of the plane shown by the viewport and the size of a pixel, using the current matrices.
+ * @param view is the rectangle of the plane shown by the viewport.
+ * @param pixelSize is the size of a pixel in the plane.
+ */
+void DrawableTrapezoidalMap::getView(cg3::BoundingBox2& view, double& pixelSize) const {
+    GLdouble modelview[16], projection[16];
+    GLint viewport[4];
+    glGetDoublev(GL_MODELVIEW_MATRIX, modelview);
+    glGetDoublev(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    GLdouble minX, minY, maxX, maxY, z;
+    gluUnProject(viewport[0], viewport[1], 0, modelview, projection, viewport, &minX, &minY, &z);
+    gluUnProject(viewport[0] + viewport[2], viewport[1] + viewport[3], 0, modelview, projection, viewport, &maxX, &maxY, &z);
+
+    view = cg3::BoundingBox2(cg3::Point2d(std::min(minX, maxX), std::min(minY, maxY)), cg3::Point2d(std::max(minX, maxX), std::max(minY, maxY)));
+    pixelSize = std::max(view.lengthX() / std::max(viewport[2], 1), view.lengthY() / std::max(viewport[3], 1));
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::cull allows the indexes of the visible trapezoids and of their vertical lines to be computed for the view.
+ * The culled window is the view enlarged by half of its size on each side, and the trapezoids smaller than half of the minimum pixel size
+ * are skipped, so the indexes can be kept while the view moves inside the window and the pixel size changes less than a factor of two.
+ * When the window is less than 1/128 of the trapezoidal map and the directed acyclic graph is known, the trapezoids are found with
+ * algorithms::windowQuery, otherwise all trapezoids are checked, which is faster since the window query costs as much as about fifty checks per trapezoid.
+ * The window query also descends the directed acyclic graph once for each segment crossing the window, so its expected cost is
+ * O((1 + s) log n + k) rather than O(log n + k): a window crossed by many segments costs more than the trapezoids it returns.
+ * @param view is the rectangle of the plane shown by the viewport.
+ * @param pixelSize is the size of a pixel in the plane.
+ */
+void DrawableTrapezoidalMap::cull(const cg3::BoundingBox2& view, const double& pixelSize) const {
+    const size_t trapezoidNumber = vertices.size() / 8;
+    const cg3::Point2d margin(view.lengthX() / 2, view.lengthY() / 2);
+    const double minimumSize = minimumPixelSize * pixelSize / 2;
+
+    culledWindow = cg3::BoundingBox2(view.min() - margin, view.max() + margin);
+    culledPixelSize = pixelSize;
+    culledUpdateNumber = drawnUpdateNumber;
+
+    visibleTrapezoidIndexes.clear();
+    visibleVerticalLineIndexes.clear();
+
+    const cg3::BoundingBox2 boundingBox(getPoint(0), getPoint(1));
+    const bool smallWindow = 128 * culledWindow.lengthX() * culledWindow.lengthY() < boundingBox.lengthX() * boundingBox.lengthY();
+
+    windowTrapezoids.clear();
+    windowSegments.clear();
+
+    if (directedAcyclicGraph != nullptr && smallWindow && !drawingSnapshots && getUpdateNumber() == drawnUpdateNumber)
+        algorithms::windowQuery(*this, *directedAcyclicGraph, culledWindow, windowTrapezoids, windowSegments);
+    else
+        for (size_t id = 0; id < trapezoidNumber; id++)
+            windowTrapezoids.push_back(id);
+
+    for (const size_t& id : windowTrapezoids) {
+        if (id >= trapezoidNumber)
+            continue;
+
+        // the left corners share the x coordinate, as the right ones do
+        const double* corners = vertices.data() + 8 * id;
+        const double minX = corners[0], maxX = corners[4];
+        const double minY = std::min(corners[1], corners[7]), maxY = std::max(corners[3], corners[5]);
+
+        if (maxX < culledWindow.min().x() || minX > culledWindow.max().x() || maxY < culledWindow.min().y() || minY > culledWindow.max().y())
+            continue;
+
+        if (maxX - minX < minimumSize && maxY - minY < minimumSize)
+            continue;
+
+        for (unsigned int i = 0; i < 4; i++) {
+            visibleTrapezoidIndexes.push_back(static_cast<unsigned int>(4 * id) + i);
+            visibleVerticalLineIndexes.push_back(verticalLineIndexes[4 * id + i]);
+        }
+    }
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::resetLineCoefficients allows the coordinates of the points and the coefficients of the lines to be
+ * computed again, when the trapezoids are not an update of the drawn ones and their geometry store may be another one.
+ */
+void DrawableTrapezoidalMap::resetLineCoefficients() {
+    pointCoordinates.clear();
+    lineCoefficients.clear();
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::updateLineCoefficients allows the coordinates of the points and the coefficients of the lines of the segments
+ * added to the geometry store to be appended. The lines 0 and 1 are the bottom and the top side of the bounding box, the line of the segment
+ * with index s is the line s + 2. While the trapezoidal map has no segments only the corners are kept, since the geometry store may be cleared after it.
+ * @param trapezoidalMap is the trapezoidal map whose trapezoids are computed, this one or a snapshot of another one.
+ */
+void DrawableTrapezoidalMap::updateLineCoefficients(const TrapezoidalMap& trapezoidalMap) {
+    const size_t pointNumber = trapezoidalMap.getSegmentNumber() > 0 ? trapezoidalMap.getPoints().size() : 2;
+    const size_t segmentNumber = trapezoidalMap.getSegmentNumber() > 0 ? trapezoidalMap.getIndexedSegments().size() : 0;
+
+    if (trapezoidalMap.getSegmentNumber() == 0 || pointCoordinates.size() > 2 * pointNumber || lineCoefficients.size() > geometricUtils::LINE_COEFFICIENT_NUMBER * (segmentNumber + 2))
+        resetLineCoefficients();
+
+    if (lineCoefficients.empty()) {
+        lineCoefficients.resize(2 * geometricUtils::LINE_COEFFICIENT_NUMBER);
+        const cg3::Point2d& boundingBoxMin = trapezoidalMap.getPoint(0);
+        const cg3::Point2d& boundingBoxMax = trapezoidalMap.getPoint(1);
+        geometricUtils::lineCoefficients(cg3::Segment2d(boundingBoxMin, cg3::Point2d(boundingBoxMax.x(), boundingBoxMin.y())), lineCoefficients.data());
+        geometricUtils::lineCoefficients(cg3::Segment2d(cg3::Point2d(boundingBoxMin.x(), boundingBoxMax.y()), boundingBoxMax), lineCoefficients.data() + geometricUtils::LINE_COEFFICIENT_NUMBER);
+    }
+
+    for (size_t id = pointCoordinates.size() / 2; id < pointNumber; id++) {
+        pointCoordinates.push_back(trapezoidalMap.getPoint(id).x());
+        pointCoordinates.push_back(trapezoidalMap.getPoint(id).y());
+    }
+
+    size_t line = lineCoefficients.size() / geometricUtils::LINE_COEFFICIENT_NUMBER;
+    lineCoefficients.resize(geometricUtils::LINE_COEFFICIENT_NUMBER * (segmentNumber + 2));
+
+    for (; line < segmentNumber + 2; line++)
+        geometricUtils::lineCoefficients(trapezoidalMap.getSegment(line - 2), lineCoefficients.data() + geometricUtils::LINE_COEFFICIENT_NUMBER * line);
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::setTrapezoidVertices allows the corners of a range of trapezoids, their colors and their vertical lines to be
+ * stored in the vertex arrays. The corners are written directly in the vertex array, one block of trapezoids at a time.
+ * @param trapezoidalMap is the trapezoidal map which contains the trapezoids, this one or a snapshot of another one.
+ * @param firstTrapezoid is the index of the first trapezoid.
+ * @param lastTrapezoid is the index after the last trapezoid.
+ */
+void DrawableTrapezoidalMap::setTrapezoidVertices(const TrapezoidalMap& trapezoidalMap, const size_t& firstTrapezoid, const size_t& lastTrapezoid) {
+    trapezoidLinesAndPoints.resize(4 * TRAPEZOID_BLOCK_SIZE);
+
+    for (size_t first = firstTrapezoid; first < lastTrapezoid; first += TRAPEZOID_BLOCK_SIZE) {
+        const size_t trapezoidNumber = std::min(lastTrapezoid - first, static_cast<size_t>(TRAPEZOID_BLOCK_SIZE));
+
+        for (size_t i = 0; i < trapezoidNumber; i++)
+            setTrapezoidLinesAndPoints(trapezoidalMap, first + i, trapezoidLinesAndPoints.data() + 4 * i);
+
+        geometricUtils::trapezoidCorners(lineCoefficients.data(), pointCoordinates.data(), trapezoidLinesAndPoints.data(), trapezoidNumber, vertices.data() + 8 * first);
+
+        for (size_t id = first; id < first + trapezoidNumber; id++)
+            setTrapezoidColorAndVerticalLines(trapezoidalMap, id);
+    }
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::setTrapezoidVertices allows the corners of some trapezoids, their colors and their vertical lines to be
+ * stored in the vertex arrays, as the trapezoids changed by an update. The corners are computed in a block and then copied.
+ * @param trapezoidalMap is the trapezoidal map which contains the trapezoids, this one or a snapshot of another one.
+ * @param trapezoids are the indexes of the trapezoids, those from firstNewTrapezoid on are skipped.
+ * @param firstNewTrapezoid is the index of the first new trapezoid, which is computed with the range of the new ones.
+ */
+void DrawableTrapezoidalMap::setTrapezoidVertices(const TrapezoidalMap& trapezoidalMap, const std::vector<size_t>& trapezoids, const size_t& firstNewTrapezoid) {
+    trapezoidLinesAndPoints.resize(4 * TRAPEZOID_BLOCK_SIZE);
+    trapezoidCorners.resize(8 * TRAPEZOID_BLOCK_SIZE);
+
+    for (size_t first = 0; first < trapezoids.size(); first += TRAPEZOID_BLOCK_SIZE) {
+        const size_t last = std::min(first + TRAPEZOID_BLOCK_SIZE, trapezoids.size());
+        size_t trapezoidNumber = 0;
+
+        for (size_t i = first; i < last; i++)
+            if (trapezoids[i] < firstNewTrapezoid)
+                setTrapezoidLinesAndPoints(trapezoidalMap, trapezoids[i], trapezoidLinesAndPoints.data() + 4 * trapezoidNumber++);
+
+        geometricUtils::trapezoidCorners(lineCoefficients.data(), pointCoordinates.data(), trapezoidLinesAndPoints.data(), trapezoidNumber, trapezoidCorners.data());
+
+        trapezoidNumber = 0;
+
+        for (size_t i = first; i < last; i++) {
+            if (trapezoids[i] < firstNewTrapezoid) {
+                std::copy(trapezoidCorners.begin() + 8 * trapezoidNumber, trapezoidCorners.begin() + 8 * (trapezoidNumber + 1), vertices.begin() + 8 * trapezoids[i]);
+                setTrapezoidColorAndVerticalLines(trapezoidalMap, trapezoids[i]);
+                trapezoidNumber++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::setTrapezoidLinesAndPoints gives the lines of the top and the bottom segment and the left and the right point of the trapezoid,
+ * as geometricUtils::trapezoidCorners takes them. A null top or bottom segment is the top or the bottom side of the bounding box.
+ * @param trapezoidalMap is the trapezoidal map which contains the trapezoid.
+ * @param id is the index of the trapezoid.
+ * @param linesAndPoints is the array of 4 indexes which receives the top line, the bottom line, the left point and the right point.
+ */
+void DrawableTrapezoidalMap::setTrapezoidLinesAndPoints(const TrapezoidalMap& trapezoidalMap, const size_t& id, size_t* linesAndPoints) const {
+    const Trapezoid& trapezoid = trapezoidalMap.getTrapezoids()[id];
+
+    linesAndPoints[0] = trapezoid.getTopSegment() != std::numeric_limits<size_t>::max() ? trapezoid.getTopSegment() + 2 : 1;
+    linesAndPoints[1] = trapezoid.getBottomSegment() != std::numeric_limits<size_t>::max() ? trapezoid.getBottomSegment() + 2 : 0;
+    linesAndPoints[2] = trapezoid.getLeftPoint();
+    linesAndPoints[3] = trapezoid.getRightPoint();
+}
+
+/**
+ * @brief DrawableTrapezoidalMap::setTrapezoidColorAndVerticalLines allows the color of the corners of the trapezoid and its vertical lines to be stored in the vertex arrays.
+ * A missing vertical line, on the sides of the bounding box, is stored as a line from a corner to itself, which is not drawn.
+ * @param trapezoidalMap is the trapezoidal map which contains the trapezoid, this one or a snapshot of another one.
+ * @param id is the index of the trapezoid, whose corners are stored from the position 4 * id.
+ */
+void DrawableTrapezoidalMap::setTrapezoidColorAndVerticalLines(const TrapezoidalMap& trapezoidalMap, const size_t& id) {
+    const Trapezoid& trapezoid = trapezoidalMap.getTrapezoids()[id];
+    const cg3::Color trapezoidColor = getTrapezoidColor(id);
+
+    for (size_t i = 0; i < 4; i++) {
+        vertexColors[12 * id + 3 * i] = static_cast<unsigned char>(trapezoidColor.red());
+        vertexColors[12 * id + 3 * i + 1] = static_cast<unsigned char>(trapezoidColor.green());
+        vertexColors[12 * id + 3 * i + 2] = static_cast<unsigned char>(trapezoidColor.blue());
+    }
+
+    const unsigned int firstVertex = static_cast<unsigned int>(4 * id);
+
+    // the left vertical line is missing if the left point is the lower left point of the bounding box
+    verticalLineIndexes[4 * id] = firstVertex;
+    verticalLineIndexes[4 * id + 1] = trapezoid.getLeftPoint() != 0 ? firstVertex + 1 : firstVertex;
+
+    // the right vertical line is missing if the right point is the upper right point of the bounding box
+    verticalLineIndexes[4 * id + 2] = firstVertex + 2;
+    verticalLineIndexes[4 * id + 3] = trapezoid.getRightPoint() != 1 ? firstVertex + 3 : firstVertex + 2;
 }
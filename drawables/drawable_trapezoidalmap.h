@@ -2,32 +2,79 @@
 #define DRAWABLE_TRAPEZOIDALMAP_H
 
 #include "data_structures/trapezoidalmap.h"
+#include "data_structures/directed_acyclic_graph.h"
 #include <cg3/viewer/interfaces/drawable_object.h>
 #include <cg3/utilities/color.h>
 
 /**
  * @brief The DrawableTrapezoidalMap class allows drawing trapezoids and vertical lines and highlighting the query output trapezoid.
+ * The color of each trapezoid is computed from its index, so it is the same in every run and it is not stored apart from the vertex arrays.
+ * The corners of the trapezoids and their colors are kept in vertex arrays, which are updated only for the trapezoids changed by
+ * the last update of the trapezoidal map, and the vertical lines are indexes of those corners. Each frame draws the visible trapezoids
+ * with one call and their vertical lines with another one.
+ * Only the trapezoids which intersect the view and are larger than the minimum pixel size are drawn: their indexes are computed
+ * for a window larger than the view and kept until the view leaves it or the pixel size changes by a factor of two, while the
+ * skipped trapezoids are replaced by a gray background.
+ * While another thread builds a trapezoidal map, the vertex arrays can show its snapshots instead of this trapezoidal map, and they are
+ * kept when the built trapezoidal map is swapped with this one.
+ * The corners are computed in blocks of trapezoids by geometricUtils::trapezoidCorners, from the coordinates of the points and the
+ * coefficients of the lines of the segments, which are computed once for each point and segment and kept until all trapezoids are computed again.
  */
 class DrawableTrapezoidalMap : public TrapezoidalMap, public cg3::DrawableObject {
 
 public:
-    DrawableTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax);
+    DrawableTrapezoidalMap(const cg3::Point2d& boundingBoxMin, const cg3::Point2d& boundingBoxMax, const std::shared_ptr<GeometryStore>& geometryStore);
 
     void draw() const;
     cg3::Point3d sceneCenter() const;
     double sceneRadius() const;
 
+    void setDirectedAcyclicGraph(const DirectedAcyclicGraph* directedAcyclicGraph);
+    void setMinimumPixelSize(const double& minimumPixelSize);
+
     void highlight(const size_t& lastTrapezoidFound);
-    void addTrapezoidColors();
+    cg3::Color getTrapezoidColor(const size_t& id) const;
+    void updateVertexArrays();
+    void appendSnapshot(const TrapezoidalMap& snapshot, const std::vector<size_t>& updatedTrapezoids);
     void clear();
+    void swap(TrapezoidalMap& other);
 
 private:
     void initialize();
+    void resetLineCoefficients();
+    void updateLineCoefficients(const TrapezoidalMap& trapezoidalMap);
+    void setTrapezoidVertices(const TrapezoidalMap& trapezoidalMap, const size_t& firstTrapezoid, const size_t& lastTrapezoid);
+    void setTrapezoidVertices(const TrapezoidalMap& trapezoidalMap, const std::vector<size_t>& trapezoids, const size_t& firstNewTrapezoid);
+    void setTrapezoidLinesAndPoints(const TrapezoidalMap& trapezoidalMap, const size_t& id, size_t* linesAndPoints) const;
+    void setTrapezoidColorAndVerticalLines(const TrapezoidalMap& trapezoidalMap, const size_t& id);
+    void getView(cg3::BoundingBox2& view, double& pixelSize) const;
+    void cull(const cg3::BoundingBox2& view, const double& pixelSize) const;
 
     const cg3::Color highlightColor = cg3::Color(0, 0, 0);
-    std::vector<cg3::Color> trapezoidColors;
     size_t lastTrapezoidFound = std::numeric_limits<size_t>::max();
 
+    std::vector<double> vertices;
+    std::vector<unsigned char> vertexColors;
+    std::vector<unsigned int> verticalLineIndexes;
+    size_t drawnUpdateNumber;
+    bool drawingSnapshots = false;
+
+    std::vector<double> pointCoordinates;
+    std::vector<double> lineCoefficients;
+    std::vector<size_t> trapezoidLinesAndPoints;
+    std::vector<double> trapezoidCorners;
+
+    const DirectedAcyclicGraph* directedAcyclicGraph = nullptr;
+    double minimumPixelSize = 1;
+
+    mutable std::vector<unsigned int> visibleTrapezoidIndexes;
+    mutable std::vector<unsigned int> visibleVerticalLineIndexes;
+    mutable std::vector<size_t> windowTrapezoids;
+    mutable std::vector<size_t> windowSegments;
+    mutable cg3::BoundingBox2 culledWindow;
+    mutable double culledPixelSize = 0;
+    mutable size_t culledUpdateNumber = std::numeric_limits<size_t>::max();
+
 };
 
 #endif // DRAWABLE_TRAPEZOIDALMAP_H
@@ -13,11 +13,52 @@ DrawableTrapezoidalMapDataset::DrawableTrapezoidalMapDataset() :
 
 void DrawableTrapezoidalMapDataset::draw() const
 {
-    for (const cg3::Point2d& p : getPoints()) {
-        cg3::opengl::drawPoint2(p, pointColor, static_cast<int>(pointSize));
+    updateArrays();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, vertices.data());
+
+    //The first points of a shared geometry store are the corners of the bounding box trapezoid
+    const size_t cornerNumber = getGeometryStore()->getCornerNumber();
+    glPointSize(pointSize);
+    glColor3f(pointColor.redF(), pointColor.greenF(), pointColor.blueF());
+    glDrawArrays(GL_POINTS, static_cast<GLint>(cornerNumber), static_cast<GLsizei>(vertices.size() / 2 - cornerNumber));
+
+    glLineWidth(segmentSize);
+    glColor3f(segmentColor.redF(), segmentColor.greenF(), segmentColor.blueF());
+    glDrawElements(GL_LINES, static_cast<GLsizei>(segmentIndexes.size()), GL_UNSIGNED_INT, segmentIndexes.data());
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void DrawableTrapezoidalMapDataset::clear()
+{
+    TrapezoidalMapDataset::clear();
+    vertices.clear();
+    segmentIndexes.clear();
+}
+
+void DrawableTrapezoidalMapDataset::swap(TrapezoidalMapDataset& other)
+{
+    //The swapped points and segments are not an extension of the stored ones, so the arrays are filled again
+    TrapezoidalMapDataset::swap(other);
+    vertices.clear();
+    segmentIndexes.clear();
+}
+
+void DrawableTrapezoidalMapDataset::updateArrays() const
+{
+    //Points and segments are only added until the dataset is cleared, so only the new ones are stored
+    const ChunkedVector<cg3::Point2d>& points = getPoints();
+    for (size_t i = vertices.size() / 2; i < points.size(); i++) {
+        vertices.push_back(points[i].x());
+        vertices.push_back(points[i].y());
     }
-    for (const cg3::Segment2d& seg : getSegments()) {
-        cg3::opengl::drawLine2(seg.p1(), seg.p2(), segmentColor, static_cast<int>(segmentSize));
+
+    const ChunkedVector<IndexedSegment2d>& indexedSegments = getIndexedSegments();
+    for (size_t i = segmentIndexes.size() / 2; i < indexedSegments.size(); i++) {
+        segmentIndexes.push_back(static_cast<unsigned int>(indexedSegments[i].first));
+        segmentIndexes.push_back(static_cast<unsigned int>(indexedSegments[i].second));
     }
 }
 
@@ -9,6 +9,8 @@
 
 /**
  * @brief Class to draw the segment container.
+ * Points and segments are kept in a vertex array and in an index array, which are extended with the new points and segments
+ * when the dataset changes, so every frame draws all points and all segments with two calls.
  */
 class DrawableTrapezoidalMapDataset : public TrapezoidalMapDataset, public cg3::DrawableObject
 {
@@ -33,14 +35,22 @@ public:
     unsigned int getSegmentSize() const;
     void setSegmentSize(unsigned int value);
 
+    void clear();
+    void swap(TrapezoidalMapDataset& other);
+
 private:
 
+    void updateArrays() const;
+
     cg3::Color pointColor;
     cg3::Color segmentColor;
 
     unsigned int pointSize;
     unsigned int segmentSize;
 
+    mutable std::vector<double> vertices;
+    mutable std::vector<unsigned int> segmentIndexes;
+
 };
 
 #endif // DRAWABLE_TRAPEZOIDALMAP_DATASET_H
@@ -0,0 +1,133 @@
+#include "dag_point_locator.h"
+
+#include "algorithms/algorithms.h"
+
+#include <cmath>
+
+const size_t DagPointLocator::DEPTH_FACTOR;
+const size_t DagPointLocator::MAX_BUILDS;
+const size_t DagPointLocator::REBUILD_GROWTH_FACTOR;
+
+/**
+ * @brief DagPointLocator::DagPointLocator is the constructor of the class, the entry grid is disabled.
+ * @param trapezoidalMap is the trapezoidal map whose trapezoids are returned by the queries.
+ * @param directedAcyclicGraph is the directed acyclic graph used to answer the queries.
+ */
+DagPointLocator::DagPointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph) :
+    PointLocator(trapezoidalMap, directedAcyclicGraph), entryGrid(trapezoidalMap.getPoint(0), trapezoidalMap.getPoint(1)), builtSegmentNumber(0) {
+
+}
+
+/**
+ * @brief DagPointLocator::getName returns the name of the engine.
+ * @return the name of the engine.
+ */
+std::string DagPointLocator::getName() const {
+    return "Directed acyclic graph";
+}
+
+/**
+ * @brief DagPointLocator::setEntryGridResolution allows the entry grid to be built again over the current directed acyclic graph.
+ * @param resolution is the number of cells on each side of the bounding box, 0 disables the grid.
+ */
+void DagPointLocator::setEntryGridResolution(const size_t& resolution) {
+    algorithms::build(entryGrid, trapezoidalMap, directedAcyclicGraph, resolution);
+}
+
+/**
+ * @brief DagPointLocator::build allows the segments to be inserted in a random order, repeating the construction while the directed acyclic
+ * graph is too deep.
+ * @param segments are the segments to be inserted.
+ */
+void DagPointLocator::build(const std::vector<cg3::Segment2d>& segments) {
+    rebuild(segments, std::function<bool()>());
+}
+
+/**
+ * @brief DagPointLocator::build allows the segments to be inserted in a random order as the other build, calling a function after each insertion,
+ * so a worker thread can publish the progress of the construction and stop it.
+ * @param segments are the segments to be inserted.
+ * @param segmentAdded is called after each insertion, if it returns false the construction stops with the segments inserted so far.
+ */
+void DagPointLocator::build(const std::vector<cg3::Segment2d>& segments, const std::function<bool()>& segmentAdded) {
+    rebuild(segments, segmentAdded);
+}
+
+/**
+ * @brief DagPointLocator::insert allows the segment to be added to the trapezoidal map, to the directed acyclic graph and to the entry grid.
+ * The entry nodes stay valid also when another engine inserts segments, since nodes are only replaced by the subtrees which refine them.
+ * A too deep directed acyclic graph is built again only if the segments are at least REBUILD_GROWTH_FACTOR times those of the last construction:
+ * each rebuild is paid by the insertions since the previous one, so sorted segments do not trigger a rebuild at every insertion.
+ * Since a rebuild clears the data structures in place, no other thread may query them during the insertion.
+ * @param segment is the segment to be inserted.
+ */
+void DagPointLocator::insert(const cg3::Segment2d& segment) {
+    if (entryGrid.getResolution() > 0)
+        algorithms::add(trapezoidalMap, directedAcyclicGraph, entryGrid, constructionContext, segment);
+    else
+        algorithms::add(trapezoidalMap, directedAcyclicGraph, constructionContext, segment);
+
+    // an unlucky insertion order is corrected building again all segments of the map
+    const size_t segmentNumber = trapezoidalMap.getSegmentNumber();
+
+    if (segmentNumber >= REBUILD_GROWTH_FACTOR * builtSegmentNumber &&
+            directedAcyclicGraph.getMaxDepth() > DEPTH_FACTOR * static_cast<size_t>(std::ceil(std::log2(static_cast<double>(segmentNumber) + 1)))) {
+        std::vector<cg3::Segment2d> segments;
+
+        for (size_t i = 0; i < trapezoidalMap.getIndexedSegments().size(); i++)
+            if (trapezoidalMap.containsSegment(i))
+                segments.push_back(trapezoidalMap.getSegment(i));
+
+        rebuild(segments, std::function<bool()>());
+    }
+}
+
+/**
+ * @brief DagPointLocator::query returns the trapezoid index where the point is in, following the directed acyclic graph from the entry
+ * node of its cell.
+ * @param point is the query point.
+ * @return the trapezoid index where the point is in.
+ */
+size_t DagPointLocator::query(const cg3::Point2d& point) {
+    return algorithms::query(trapezoidalMap, directedAcyclicGraph, entryGrid, point);
+}
+
+/**
+ * @brief DagPointLocator::queryBatch allows many points to be located following the directed acyclic graph in packets of close points,
+ * which compare each node with all their points at once.
+ * @param points are the query points.
+ * @param trapezoids are the trapezoid indexes where the points are in.
+ */
+void DagPointLocator::queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids) {
+    algorithms::query(trapezoidalMap, directedAcyclicGraph, entryGrid, points, trapezoids);
+}
+
+/**
+ * @brief DagPointLocator::memoryUsage returns the number of bytes of the entry grid and of the construction context, without the trapezoidal map and the directed acyclic graph
+ * which are shared by all engines.
+ * @return the number of bytes of the structures of the engine.
+ */
+size_t DagPointLocator::memoryUsage() const {
+    return entryGrid.memoryUsage() + constructionContext.memoryUsage();
+}
+
+/**
+ * @brief DagPointLocator::rebuild allows the trapezoidal map, the directed acyclic graph and the entry grid to be built from scratch.
+ * @param segments are the segments to be inserted.
+ * @param segmentAdded is called after each insertion, it can be empty.
+ */
+void DagPointLocator::rebuild(const std::vector<cg3::Segment2d>& segments, const std::function<bool()>& segmentAdded) {
+    algorithms::build(trapezoidalMap, directedAcyclicGraph, segments, DEPTH_FACTOR, MAX_BUILDS, segmentAdded);
+    algorithms::build(entryGrid, trapezoidalMap, directedAcyclicGraph, entryGrid.getResolution());
+    builtSegmentNumber = trapezoidalMap.getSegmentNumber();
+}
+
+/**
+ * @brief DagPointLocator::clear allows to delete the directed acyclic graph, the trapezoidal map is cleared by its owner.
+ * The cells of the entry grid enter again at the root.
+ */
+void DagPointLocator::clear() {
+    directedAcyclicGraph.clear();
+    entryGrid.initialize(entryGrid.getResolution());
+    builtSegmentNumber = 0;
+}
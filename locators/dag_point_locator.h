@@ -0,0 +1,48 @@
+#ifndef DAG_POINT_LOCATOR_H
+#define DAG_POINT_LOCATOR_H
+
+#include "point_locator.h"
+#include "data_structures/entry_grid.h"
+
+#include <functional>
+
+/**
+ * @brief The DagPointLocator class answers the queries with the directed acyclic graph of the randomized incremental construction,
+ * so it is always up to date. An optional entry grid lets the queries start below the root of the directed acyclic graph.
+ * When the depth of the directed acyclic graph exceeds DEPTH_FACTOR * log2(n + 1), it is built again with a new random order, but only
+ * once the number of segments has grown by REBUILD_GROWTH_FACTOR since the last construction, so the rebuilds cost O(n log n) in total.
+ * A rebuild clears the trapezoidal map and the directed acyclic graph in place, so insert is not safe while other threads run
+ * algorithms::query on them: concurrent readers need algorithms::add, which never rebuilds, or a VersionedTrapezoidalMap.
+ */
+class DagPointLocator : public PointLocator {
+
+public:
+    DagPointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph);
+
+    std::string getName() const;
+
+    void setEntryGridResolution(const size_t& resolution);
+
+    void build(const std::vector<cg3::Segment2d>& segments);
+    void build(const std::vector<cg3::Segment2d>& segments, const std::function<bool()>& segmentAdded);
+    void insert(const cg3::Segment2d& segment);
+    size_t query(const cg3::Point2d& point);
+    void queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids);
+
+    size_t memoryUsage() const;
+
+    void clear();
+
+    static const size_t DEPTH_FACTOR = 8;
+    static const size_t MAX_BUILDS = 16;
+    static const size_t REBUILD_GROWTH_FACTOR = 2;
+
+private:
+    void rebuild(const std::vector<cg3::Segment2d>& segments, const std::function<bool()>& segmentAdded);
+
+    EntryGrid entryGrid;
+    size_t builtSegmentNumber;
+
+};
+
+#endif // DAG_POINT_LOCATOR_H
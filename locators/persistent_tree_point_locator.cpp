@@ -0,0 +1,83 @@
+#include "persistent_tree_point_locator.h"
+
+#include "algorithms/algorithms.h"
+
+/**
+ * @brief PersistentTreePointLocator::PersistentTreePointLocator is the constructor of the class, the persistent search tree is built at the first query.
+ * @param trapezoidalMap is the trapezoidal map whose trapezoids are returned by the queries.
+ * @param directedAcyclicGraph is the directed acyclic graph used to insert the segments.
+ */
+PersistentTreePointLocator::PersistentTreePointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph) :
+    PointLocator(trapezoidalMap, directedAcyclicGraph), builtUpdateNumber(std::numeric_limits<size_t>::max()) {
+
+}
+
+/**
+ * @brief PersistentTreePointLocator::getName returns the name of the engine.
+ * @return the name of the engine.
+ */
+std::string PersistentTreePointLocator::getName() const {
+    return "Persistent search tree";
+}
+
+/**
+ * @brief PersistentTreePointLocator::insert allows the segment to be added to the trapezoidal map and to the directed acyclic graph.
+ * @param segment is the segment to be inserted.
+ */
+void PersistentTreePointLocator::insert(const cg3::Segment2d& segment) {
+    algorithms::add(trapezoidalMap, directedAcyclicGraph, constructionContext, segment);
+}
+
+/**
+ * @brief PersistentTreePointLocator::query returns the trapezoid index where the point is in, using the version of the persistent search tree at its x coordinate.
+ * @param point is the query point.
+ * @return the trapezoid index where the point is in.
+ */
+size_t PersistentTreePointLocator::query(const cg3::Point2d& point) {
+    update();
+
+    return algorithms::query(trapezoidalMap, persistentSearchTree, point);
+}
+
+/**
+ * @brief PersistentTreePointLocator::queryBatch allows many points to be located, building the persistent search tree at most once.
+ * @param points are the query points.
+ * @param trapezoids are the trapezoid indexes where the points are in.
+ */
+void PersistentTreePointLocator::queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids) {
+    update();
+
+    trapezoids.resize(points.size());
+
+    for (size_t i = 0; i < points.size(); i++)
+        trapezoids[i] = algorithms::query(trapezoidalMap, persistentSearchTree, points[i]);
+}
+
+/**
+ * @brief PersistentTreePointLocator::memoryUsage returns the number of bytes of the persistent search tree and of the construction context, without the trapezoidal map and the directed acyclic graph
+ * which are shared by all engines.
+ * @return the number of bytes of the structures of the engine.
+ */
+size_t PersistentTreePointLocator::memoryUsage() const {
+    return persistentSearchTree.memoryUsage() + constructionContext.memoryUsage();
+}
+
+/**
+ * @brief PersistentTreePointLocator::clear allows to delete the persistent search tree and the directed acyclic graph.
+ */
+void PersistentTreePointLocator::clear() {
+    persistentSearchTree.clear();
+    directedAcyclicGraph.clear();
+    builtUpdateNumber = std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief PersistentTreePointLocator::update allows the persistent search tree to be built again if the trapezoidal map has been updated since the last build,
+ * also by another engine sharing it.
+ */
+void PersistentTreePointLocator::update() {
+    if (builtUpdateNumber != trapezoidalMap.getUpdateNumber()) {
+        persistentSearchTree.build(trapezoidalMap);
+        builtUpdateNumber = trapezoidalMap.getUpdateNumber();
+    }
+}
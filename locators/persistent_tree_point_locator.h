@@ -0,0 +1,35 @@
+#ifndef PERSISTENT_TREE_POINT_LOCATOR_H
+#define PERSISTENT_TREE_POINT_LOCATOR_H
+
+#include "point_locator.h"
+#include "data_structures/persistent_search_tree.h"
+
+/**
+ * @brief The PersistentTreePointLocator class answers the queries with the persistent search tree of the sweep line over the trapezoidal map.
+ * The segments are inserted with the randomized incremental construction, and the persistent search tree is built again at the first
+ * query after the trapezoids of the map change.
+ */
+class PersistentTreePointLocator : public PointLocator {
+
+public:
+    PersistentTreePointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph);
+
+    std::string getName() const;
+
+    void insert(const cg3::Segment2d& segment);
+    size_t query(const cg3::Point2d& point);
+    void queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids);
+
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+    void update();
+
+    PersistentSearchTree persistentSearchTree;
+    size_t builtUpdateNumber;
+
+};
+
+#endif // PERSISTENT_TREE_POINT_LOCATOR_H
@@ -0,0 +1,39 @@
+#include "point_locator.h"
+
+/**
+ * @brief PointLocator::PointLocator is the constructor of the class which stores the data structures shared by all engines.
+ * @param trapezoidalMap is the trapezoidal map whose trapezoids are returned by the queries.
+ * @param directedAcyclicGraph is the directed acyclic graph updated together with the trapezoidal map.
+ */
+PointLocator::PointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph) :
+    trapezoidalMap(trapezoidalMap), directedAcyclicGraph(directedAcyclicGraph) {
+
+}
+
+/**
+ * @brief PointLocator::~PointLocator is the destructor of the class.
+ */
+PointLocator::~PointLocator() {
+
+}
+
+/**
+ * @brief PointLocator::build allows all segments to be inserted, the engines which build their structure at once can override it.
+ * @param segments are the segments to be inserted.
+ */
+void PointLocator::build(const std::vector<cg3::Segment2d>& segments) {
+    for (const cg3::Segment2d& segment : segments)
+        insert(segment);
+}
+
+/**
+ * @brief PointLocator::queryBatch allows many points to be located, the result of each point is at the same index.
+ * @param points are the query points.
+ * @param trapezoids are the trapezoid indexes where the points are in.
+ */
+void PointLocator::queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids) {
+    trapezoids.resize(points.size());
+
+    for (size_t i = 0; i < points.size(); i++)
+        trapezoids[i] = query(points[i]);
+}
@@ -0,0 +1,45 @@
+#ifndef POINT_LOCATOR_H
+#define POINT_LOCATOR_H
+
+#include <string>
+#include <vector>
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/directed_acyclic_graph.h"
+#include "data_structures/construction_context.h"
+
+/**
+ * @brief The PointLocator class is the common interface of the point location engines, so the engine which answers the queries
+ * can be selected at runtime. All engines work on the same trapezoidal map and directed acyclic graph, which are updated by the
+ * randomized incremental construction, so the trapezoid indexes they return are the same, with two exceptions. A point strictly between
+ * two points of the map on the same vertical line is in a trapezoid without width for the directed acyclic graph, which the engines
+ * based on slabs do not store, so they return the trapezoid next to it. A point on a segment can be placed on either side of it, since
+ * those engines evaluate the segment lines instead of testing the orientation. In both cases the returned trapezoids touch the point.
+ * Each engine keeps the scratch vectors of its insertions in a construction context, so inserting does not allocate them again.
+ */
+class PointLocator {
+
+public:
+    PointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph);
+    virtual ~PointLocator();
+
+    virtual std::string getName() const = 0;
+
+    virtual void build(const std::vector<cg3::Segment2d>& segments);
+    virtual void insert(const cg3::Segment2d& segment) = 0;
+
+    virtual size_t query(const cg3::Point2d& point) = 0;
+    virtual void queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids);
+
+    virtual size_t memoryUsage() const = 0;
+
+    virtual void clear() = 0;
+
+protected:
+    TrapezoidalMap& trapezoidalMap;
+    DirectedAcyclicGraph& directedAcyclicGraph;
+
+    ConstructionContext constructionContext;
+
+};
+
+#endif // POINT_LOCATOR_H
@@ -0,0 +1,83 @@
+#include "slab_point_locator.h"
+
+#include "algorithms/algorithms.h"
+
+/**
+ * @brief SlabPointLocator::SlabPointLocator is the constructor of the class, the slab decomposition is built at the first query.
+ * @param trapezoidalMap is the trapezoidal map whose trapezoids are returned by the queries.
+ * @param directedAcyclicGraph is the directed acyclic graph used to insert the segments.
+ */
+SlabPointLocator::SlabPointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph) :
+    PointLocator(trapezoidalMap, directedAcyclicGraph), builtUpdateNumber(std::numeric_limits<size_t>::max()) {
+
+}
+
+/**
+ * @brief SlabPointLocator::getName returns the name of the engine.
+ * @return the name of the engine.
+ */
+std::string SlabPointLocator::getName() const {
+    return "Slab decomposition";
+}
+
+/**
+ * @brief SlabPointLocator::insert allows the segment to be added to the trapezoidal map and to the directed acyclic graph.
+ * @param segment is the segment to be inserted.
+ */
+void SlabPointLocator::insert(const cg3::Segment2d& segment) {
+    algorithms::add(trapezoidalMap, directedAcyclicGraph, constructionContext, segment);
+}
+
+/**
+ * @brief SlabPointLocator::query returns the trapezoid index where the point is in, using two binary searches in the slab decomposition.
+ * @param point is the query point.
+ * @return the trapezoid index where the point is in.
+ */
+size_t SlabPointLocator::query(const cg3::Point2d& point) {
+    update();
+
+    return algorithms::query(trapezoidalMap, slabDecomposition, point);
+}
+
+/**
+ * @brief SlabPointLocator::queryBatch allows many points to be located, building the slab decomposition at most once.
+ * @param points are the query points.
+ * @param trapezoids are the trapezoid indexes where the points are in.
+ */
+void SlabPointLocator::queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids) {
+    update();
+
+    trapezoids.resize(points.size());
+
+    for (size_t i = 0; i < points.size(); i++)
+        trapezoids[i] = algorithms::query(trapezoidalMap, slabDecomposition, points[i]);
+}
+
+/**
+ * @brief SlabPointLocator::memoryUsage returns the number of bytes of the slab decomposition and of the construction context, without the trapezoidal map and the directed acyclic graph
+ * which are shared by all engines.
+ * @return the number of bytes of the structures of the engine.
+ */
+size_t SlabPointLocator::memoryUsage() const {
+    return slabDecomposition.memoryUsage() + constructionContext.memoryUsage();
+}
+
+/**
+ * @brief SlabPointLocator::clear allows to delete the slab decomposition and the directed acyclic graph.
+ */
+void SlabPointLocator::clear() {
+    slabDecomposition.clear();
+    directedAcyclicGraph.clear();
+    builtUpdateNumber = std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief SlabPointLocator::update allows the slab decomposition to be built again if the trapezoidal map has been updated since the last build,
+ * also by another engine sharing it.
+ */
+void SlabPointLocator::update() {
+    if (builtUpdateNumber != trapezoidalMap.getUpdateNumber()) {
+        slabDecomposition.build(trapezoidalMap);
+        builtUpdateNumber = trapezoidalMap.getUpdateNumber();
+    }
+}
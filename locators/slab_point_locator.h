@@ -0,0 +1,35 @@
+#ifndef SLAB_POINT_LOCATOR_H
+#define SLAB_POINT_LOCATOR_H
+
+#include "point_locator.h"
+#include "data_structures/slab_decomposition.h"
+
+/**
+ * @brief The SlabPointLocator class answers the queries with the slab decomposition of the trapezoidal map.
+ * The segments are inserted with the randomized incremental construction, and the slab decomposition is built again at the first
+ * query after the trapezoids of the map change.
+ */
+class SlabPointLocator : public PointLocator {
+
+public:
+    SlabPointLocator(TrapezoidalMap& trapezoidalMap, DirectedAcyclicGraph& directedAcyclicGraph);
+
+    std::string getName() const;
+
+    void insert(const cg3::Segment2d& segment);
+    size_t query(const cg3::Point2d& point);
+    void queryBatch(const std::vector<cg3::Point2d>& points, std::vector<size_t>& trapezoids);
+
+    size_t memoryUsage() const;
+
+    void clear();
+
+private:
+    void update();
+
+    SlabDecomposition slabDecomposition;
+    size_t builtUpdateNumber;
+
+};
+
+#endif // SLAB_POINT_LOCATOR_H
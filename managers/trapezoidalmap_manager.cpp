@@ -4,8 +4,14 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QInputDialog>
+#include <QTimer>
 
+#include <chrono>
 #include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <functional>
+#include <numeric>
 #include <cg3/data_structures/arrays/arrays.h>
 #include <cg3/utilities/timer.h>
 
@@ -18,6 +24,14 @@
 //Do not change the following line
 #define BOUNDINGBOX 1e+6
 
+//Index of the point locator selected at startup, it can be defined in the project file
+#ifndef POINT_LOCATOR
+#define POINT_LOCATOR 0
+#endif
+
+//Milliseconds between two snapshots of the trapezoidal map under construction
+#define BUILD_SNAPSHOT_INTERVAL 250
+
 
 //----------------------------------------------------------------------------------------------
 //                         You have to write your code in the area below.
@@ -39,7 +53,20 @@ TrapezoidalMapManager::TrapezoidalMapManager(QWidget *parent) :
     firstPointSelectedColor(220, 80, 80),
     firstPointSelectedSize(5),
     isFirstPointSelected(false),
-    drawableTrapezoidalMap(drawableBoundingBox.min(), drawableBoundingBox.max())
+    drawableTrapezoidalMap(drawableBoundingBox.min(), drawableBoundingBox.max(), drawableTrapezoidalMapDataset.getGeometryStore()),
+    dagPointLocator(drawableTrapezoidalMap, directedAcyclicGraph),
+    slabPointLocator(drawableTrapezoidalMap, directedAcyclicGraph),
+    persistentTreePointLocator(drawableTrapezoidalMap, directedAcyclicGraph),
+    pointLocators({&dagPointLocator, &slabPointLocator, &persistentTreePointLocator}),
+    pointLocator(pointLocators[POINT_LOCATOR]),
+    builtTrapezoidalMap(drawableBoundingBox.min(), drawableBoundingBox.max(), builtDataset.getGeometryStore()),
+    builtPointLocator(builtTrapezoidalMap, builtDirectedAcyclicGraph),
+    buildCancelled(false),
+    buildFinished(false),
+    buildSegmentNumber(0),
+    builtSegmentNumber(0),
+    allBuiltSegmentsInserted(true),
+    buildTime(0)
 {
     //NOTE 1: you probably need to initialize some objects in the constructor. You
     //can see how to initialize an attribute in the lines above. This is C++ style
@@ -85,6 +112,23 @@ TrapezoidalMapManager::TrapezoidalMapManager(QWidget *parent) :
     //the dataset.
 
     mainWindow.pushDrawableObject(&drawableTrapezoidalMap, "Trapezoidal Map");
+    drawableTrapezoidalMap.setDirectedAcyclicGraph(&directedAcyclicGraph);
+
+    for (const PointLocator* locator : pointLocators)
+        ui->pointLocatorComboBox->addItem(QString::fromStdString(locator->getName()));
+    ui->pointLocatorComboBox->setCurrentIndex(POINT_LOCATOR);
+
+#ifdef ENTRY_GRID_RESOLUTION
+    dagPointLocator.setEntryGridResolution(ENTRY_GRID_RESOLUTION);
+#endif
+
+    updateMemoryUsage();
+    updateLatencies();
+
+    buildProgressTimer.setInterval(100);
+    connect(&buildProgressTimer, SIGNAL(timeout()), this, SLOT(updateBuildProgress()));
+    ui->buildProgressBar->setVisible(false);
+    ui->cancelBuildButton->setVisible(false);
 
     //#####################################################################
 
@@ -141,8 +185,11 @@ TrapezoidalMapManager::~TrapezoidalMapManager()
     //Try to AVOID using dynamic objects whenever it is possible (it will
     //be evaluated!)
 
-
-
+    //The worker thread is stopped before the objects it builds are destroyed
+    if (buildThread.joinable()) {
+        buildCancelled = true;
+        buildThread.join();
+    }
 
     //#####################################################################
 
@@ -196,8 +243,19 @@ void TrapezoidalMapManager::addSegmentToTrapezoidalMap(const cg3::Segment2d& seg
     //structures, you could save directly the point (Point2d) in each trapezoid (it is fine).
 
     drawableTrapezoidalMap.highlight(std::numeric_limits<size_t>::max());
-    algorithms::add(drawableTrapezoidalMap, directedAcyclicGraph, segment);
-    drawableTrapezoidalMap.addTrapezoidColors();
+
+    const std::chrono::steady_clock::time_point insertStart = std::chrono::steady_clock::now();
+    pointLocator->insert(segment);
+    insertLatencies.recordSince(insertStart);
+
+    drawableTrapezoidalMap.updateVertexArrays();
+
+    scheduleMemoryUsageUpdate();
+    scheduleLatenciesUpdate();
+
+#ifdef COMPARE_POINT_LOCATORS
+    pointLocatorsCompared = false;
+#endif
 
     //#####################################################################
 
@@ -240,7 +298,18 @@ void TrapezoidalMapManager::queryTrapezoidalMap(const cg3::Point2d& queryPoint)
     //TrapezoidalMap and DAG are two separate general purpose data structures that an algorithm uses.
     //THINK ABOUT YOUR STRUCTURE BEFORE WRITING CODE!
 
-    const size_t& lastTrapezoidFound = algorithms::query(drawableTrapezoidalMap, directedAcyclicGraph, queryPoint);
+#ifdef COMPARE_POINT_LOCATORS
+    if (!pointLocatorsCompared) {
+        pointLocatorsCompared = true;
+        comparePointLocators(1000000);
+    }
+#endif
+
+    const std::chrono::steady_clock::time_point queryStart = std::chrono::steady_clock::now();
+    const size_t& lastTrapezoidFound = pointLocator->query(queryPoint);
+    queryLatencies.recordSince(queryStart);
+
+    scheduleLatenciesUpdate();
 
     //#####################################################################
 
@@ -271,7 +340,15 @@ void TrapezoidalMapManager::clearTrapezoidalMap()
     //Clear here your trapezoidal map data structure.
 
     drawableTrapezoidalMap.clear();
-    directedAcyclicGraph.clear();
+
+    for (PointLocator* locator : pointLocators)
+        locator->clear();
+
+    scheduleMemoryUsageUpdate();
+
+#ifdef COMPARE_POINT_LOCATORS
+    pointLocatorsCompared = false;
+#endif
 
     //#####################################################################
 }
@@ -282,48 +359,446 @@ void TrapezoidalMapManager::clearTrapezoidalMap()
 //---------------------------------------------------------------------
 //Define your private methods here if you need some
 
+/**
+ * @brief Select the point locator which answers the queries. All point locators share the trapezoidal map,
+ * so the segments inserted with the previous one are found by the new one.
+ * @param[in] index Index of the point locator in the combo box
+ */
+void TrapezoidalMapManager::on_pointLocatorComboBox_currentIndexChanged(int index)
+{
+    if (index >= 0)
+        pointLocator = pointLocators[static_cast<size_t>(index)];
 
+    scheduleMemoryUsageUpdate();
+}
 
+/**
+ * @brief Schedule the update of the memory usage label once control returns to the event loop,
+ * so loading many segments updates it only once and the construction time is not affected.
+ */
+void TrapezoidalMapManager::scheduleMemoryUsageUpdate()
+{
+    if (!memoryUsageUpdateScheduled) {
+        memoryUsageUpdateScheduled = true;
+        QTimer::singleShot(0, this, SLOT(updateMemoryUsage()));
+    }
+}
 
-//#####################################################################
+/**
+ * @brief Show the memory usage of the dataset, the trapezoidal map, the directed acyclic graph and the structures
+ * of the selected point locator. The label shows the total and the bytes per segment, its tooltip each container.
+ */
+void TrapezoidalMapManager::updateMemoryUsage()
+{
+    MemoryUsage memoryUsage;
 
+    memoryUsageUpdateScheduled = false;
 
+    memoryUsage.add("dataset", drawableTrapezoidalMapDataset.memoryUsage());
+    memoryUsage.add("trapezoidalMap", drawableTrapezoidalMap.memoryUsage());
+    memoryUsage.add("directedAcyclicGraph", directedAcyclicGraph.memoryUsage());
+    memoryUsage.add(pointLocator->getName(), pointLocator->memoryUsage());
+    memoryUsage.setSegmentNumber(drawableTrapezoidalMap.getSegmentNumber());
 
+    ui->memoryUsageLabel->setText(QString::number(static_cast<double>(memoryUsage.getTotal()) / (1 << 20), 'f', 2) + " MB (" +
+                                  QString::number(memoryUsage.getBytesPerSegment(), 'f', 0) + " B/segment)");
+    ui->memoryUsageLabel->setToolTip(QString::fromStdString(memoryUsage.toString()));
+}
 
+/**
+ * @brief Schedule the update of the latency labels once control returns to the event loop, so it is not measured by the timers
+ * of the query and of the incremental step.
+ */
+void TrapezoidalMapManager::scheduleLatenciesUpdate()
+{
+    if (!latenciesUpdateScheduled) {
+        latenciesUpdateScheduled = true;
+        QTimer::singleShot(0, this, SLOT(updateLatencies()));
+    }
+}
 
+/**
+ * @brief Show the number, the mean, the percentiles and the maximum of the latencies of the queries and of the incremental steps.
+ */
+void TrapezoidalMapManager::updateLatencies()
+{
+    latenciesUpdateScheduled = false;
 
-//----------------------------------------------------------------------------------------------
-//              You will probably not need to write/edit code in the area below.
-//----------------------------------------------------------------------------------------------
+    ui->queryLatencyLabel->setText(QString::fromStdString(queryLatencies.toString()));
+    ui->insertLatencyLabel->setText(QString::fromStdString(insertLatencies.toString()));
+}
 
+/**
+ * @brief Reset latencies button event handler. The latencies recorded in this session are deleted.
+ */
+void TrapezoidalMapManager::on_resetLatenciesButton_clicked()
+{
+    queryLatencies.reset();
+    insertLatencies.reset();
 
-/* ----- Private utility methods (DO NOT WRITE CODE IN THESE METHODS) ----- */
+    updateLatencies();
+}
 
 /**
- * @brief Launch the method for constructing the trapezoidal map
- * and measure its time efficiency.
+ * @brief Export latencies button event handler. The histograms of the queries and of the incremental steps are saved in a CSV file,
+ * with a line for each non-empty bucket.
  */
-void TrapezoidalMapManager::loadSegmentsTrapezoidalMapAndMeasureTime(const std::vector<cg3::Segment2d>& segments) //Do not write code here
+void TrapezoidalMapManager::on_exportLatenciesButton_clicked()
 {
-    //Output message
+    QString filename = QFileDialog::getSaveFileName(nullptr,
+                       "File containing latencies",
+                       ".",
+                       "CSV(*.csv)");
+
+    if (!filename.isEmpty()) {
+        std::ofstream outfile(filename.toStdString());
+        outfile << LatencyHistogram::CSV_HEADER << std::endl;
+        outfile << queryLatencies.toCsv("query") << insertLatencies.toCsv("insert");
+    }
+}
+
+/**
+ * @brief Load queries button event handler. The points of a text or binary file are located with the batched query of the selected
+ * point locator, and the trapezoid, the top segment and the bottom segment of each point are saved in another file.
+ * The points outside the bounding box are not located and have no trapezoid.
+ */
+void TrapezoidalMapManager::on_loadQueriesButton_clicked()
+{
+    QString filename = QFileDialog::getOpenFileName(nullptr,
+                       "Open query point file",
+                       ".",
+                       "Query points (*.txt *.bin)");
+
+    if (filename.isEmpty())
+        return;
+
+    std::string error;
+    const std::vector<cg3::Point2d> points = FileUtils::getPointsFromFile(filename.toStdString(), error);
+
+    if (!error.empty()) {
+        QMessageBox::warning(this, "Cannot load query points", QString::fromStdString(error));
+        return;
+    }
+
+    std::vector<cg3::Point2d> insidePoints;
+    std::vector<size_t> insidePointIndexes;
+    std::vector<size_t> insideTrapezoids;
+
+    for (size_t i = 0; i < points.size(); i++) {
+        if (drawableBoundingBox.isInside(points[i])) {
+            insidePoints.push_back(points[i]);
+            insidePointIndexes.push_back(i);
+        }
+    }
+
+    //The first query builds the structure of the point locator, if it is not up to date
+    if (!insidePoints.empty())
+        pointLocator->query(insidePoints.front());
+
+    std::cout << "Querying the trapezoidal map for " << insidePoints.size() << " points (" << points.size() - insidePoints.size()
+              << " outside the bounding box)..." << std::endl;
+
+    cg3::Timer t("Trapezoidal map batch query");
+    pointLocator->queryBatch(insidePoints, insideTrapezoids);
+    t.stopAndPrint();
+
+    const double queriesPerSecond = t.delay() > 0 ? static_cast<double>(insidePoints.size()) / t.delay() : 0;
+    std::cout << std::fixed << std::setprecision(0) << queriesPerSecond << std::defaultfloat << " queries per second" << std::endl << std::endl;
+
+    ui->batchQueriesLabel->setText(QString::number(t.delay(), 'f', 3) + " s (" + QString::number(queriesPerSecond, 'f', 0) + " queries/s)");
+
+    std::vector<size_t> trapezoids(points.size(), std::numeric_limits<size_t>::max());
+    std::vector<size_t> topSegments(points.size(), std::numeric_limits<size_t>::max());
+    std::vector<size_t> bottomSegments(points.size(), std::numeric_limits<size_t>::max());
+
+    for (size_t i = 0; i < insidePoints.size(); i++) {
+        const Trapezoid& trapezoid = drawableTrapezoidalMap.getTrapezoid(insideTrapezoids[i]);
+
+        trapezoids[insidePointIndexes[i]] = insideTrapezoids[i];
+        topSegments[insidePointIndexes[i]] = trapezoid.getTopSegment();
+        bottomSegments[insidePointIndexes[i]] = trapezoid.getBottomSegment();
+    }
+
+    QString resultFilename = QFileDialog::getSaveFileName(nullptr,
+                             "File containing the query results",
+                             ".",
+                             "TXT(*.txt)");
+
+    if (!resultFilename.isEmpty())
+        FileUtils::saveQueryResultsInFile(resultFilename.toStdString(), trapezoids, topSegments, bottomSegments);
+}
+
+/**
+ * @brief Start the build of the trapezoidal map on a worker thread. The drawn dataset and trapezoidal map stay unchanged until
+ * the build ends, while the canvas does not answer queries and the buttons which change the segments are disabled.
+ * @param[in] loadSegments Function which returns the segments, called on the worker thread
+ */
+void TrapezoidalMapManager::startBuild(const std::function<std::vector<cg3::Segment2d>()>& loadSegments)
+{
+    buildCancelled = false;
+    buildFinished = false;
+    buildSegmentNumber = 0;
+    builtSegmentNumber = 0;
+
+    setBuildRunning(true);
+
+    buildThread = std::thread(&TrapezoidalMapManager::build, this, loadSegments);
+    buildProgressTimer.start();
+}
+
+/**
+ * @brief Load the segments, validate each one inserting it in the built dataset, then build the trapezoidal map with the valid segments
+ * in a random order, so sorted files do not give a deep directed acyclic graph. It runs on the worker thread and it stops at the first
+ * segment after a cancellation. The progress bar counts the validated segments, then the inserted ones.
+ * @param[in] loadSegments Function which returns the segments
+ */
+void TrapezoidalMapManager::build(const std::function<std::vector<cg3::Segment2d>()>& loadSegments)
+{
+    //The structures of the previous build are released here, so the interface thread does not wait for them
+    builtTrapezoidalMap.clear();
+    builtPointLocator.clear();
+    builtDataset.clear();
+    builtTrapezoidalMapProgress.start(builtTrapezoidalMap);
+
+    const std::vector<cg3::Segment2d> segments = loadSegments();
+    buildSegmentNumber = segments.size();
+
     std::cout << "Constructing the trapezoidal map for " << segments.size() << " segments..." << std::endl;
 
-    //Timer for evaluating the efficiency of the algorithm
     cg3::Timer t("Trapezoidal map construction");
 
-    //Launch incremental step for each segment
+    const std::chrono::milliseconds snapshotInterval(BUILD_SNAPSHOT_INTERVAL);
+    std::chrono::steady_clock::time_point nextSnapshot = std::chrono::steady_clock::now() + snapshotInterval;
+
+    std::vector<cg3::Segment2d> validSegments;
+    validSegments.reserve(segments.size());
+
+    allBuiltSegmentsInserted = true;
     for (const cg3::Segment2d& segment : segments) {
-        addSegmentToTrapezoidalMap(segment);
+        if (buildCancelled)
+            break;
+
+        bool insertedSegment;
+        builtDataset.addSegment(segment, insertedSegment);
+
+        if (insertedSegment) {
+            validSegments.push_back(segment);
+        }
+        else {
+            allBuiltSegmentsInserted = false;
+            std::cout << "The segment " << segment <<
+                " will be ignored because it has intersections with other segments, "
+                "or it is degenerate." << std::endl;
+        }
+
+        builtSegmentNumber++;
+    }
+
+    if (!buildCancelled) {
+        builtSegmentNumber = 0;
+        buildSegmentNumber = validSegments.size();
+
+        //The progress counts the segments of the current construction, which starts again if its directed acyclic graph is too deep
+        builtPointLocator.build(validSegments, [&]() {
+            builtTrapezoidalMapProgress.record(builtTrapezoidalMap);
+            builtSegmentNumber = builtTrapezoidalMap.getSegmentNumber();
+
+            //If the interface thread is taking the previous snapshot, the next segment tries again
+            if (std::chrono::steady_clock::now() >= nextSnapshot && builtTrapezoidalMapProgress.publish(builtTrapezoidalMap, false))
+                nextSnapshot = std::chrono::steady_clock::now() + snapshotInterval;
+
+            return !buildCancelled;
+        });
     }
 
-    //Timer stop and visualization (both on console and UI)
     t.stopAndPrint();
-    ui->loadSegmentsTimeLabel->setNum(t.delay());
-    ui->addSegmentTimeLabel->setText("");
-    ui->queryTimeLabel->setText("");
+    buildTime = t.delay();
+
+    std::cout << std::endl;
+
+    //The last snapshot is the built trapezoidal map, so its vertex arrays are kept when it is swapped with the drawn one
+    if (!buildCancelled)
+        builtTrapezoidalMapProgress.publish(builtTrapezoidalMap, true);
+
+    buildFinished = true;
+}
+
+/**
+ * @brief Show the number of segments inserted by the worker thread and the last snapshot of the trapezoidal map under construction,
+ * whose changed trapezoids are appended to the drawn ones, and end the build when it has finished.
+ * The progress bar is busy while the segments are loaded, and the drawn segments are hidden while the snapshots are shown.
+ */
+void TrapezoidalMapManager::updateBuildProgress()
+{
+    if (buildFinished) {
+        finishBuild();
+        return;
+    }
+
+    ui->buildProgressBar->setMaximum(static_cast<int>(buildSegmentNumber));
+    ui->buildProgressBar->setValue(static_cast<int>(builtSegmentNumber));
+
+    if (appendBuildSnapshot()) {
+        mainWindow.setDrawableObjectVisibility(&drawableTrapezoidalMapDataset, false);
+        updateCanvas();
+    }
+}
+
+/**
+ * @brief Append the last snapshot published by the worker thread, if any, to the drawn trapezoidal map.
+ * @return true if a snapshot has been appended
+ */
+bool TrapezoidalMapManager::appendBuildSnapshot()
+{
+    std::vector<size_t> updatedTrapezoids;
+    const TrapezoidalMapProgress::SnapshotPointer snapshot = builtTrapezoidalMapProgress.take(updatedTrapezoids);
+
+    if (snapshot == nullptr)
+        return false;
+
+    drawableTrapezoidalMap.appendSnapshot(*snapshot, updatedTrapezoids);
+    return true;
+}
+
+/**
+ * @brief Join the worker thread and, unless the build has been cancelled, swap the built dataset, trapezoidal map and directed acyclic graph
+ * with the drawn ones, so the interface shows either the previous segments or all the new ones. The last snapshot is appended before,
+ * so the drawn vertex arrays are kept. The point locators work on the drawn trapezoidal map, whose new update number makes them build
+ * their structures again.
+ */
+void TrapezoidalMapManager::finishBuild()
+{
+    buildProgressTimer.stop();
+    buildThread.join();
+
+    appendBuildSnapshot();
+    mainWindow.setDrawableObjectVisibility(&drawableTrapezoidalMapDataset, true);
+
+    if (buildCancelled) {
+        //The snapshots of the cancelled build are replaced by the drawn trapezoidal map
+        drawableTrapezoidalMap.updateVertexArrays();
+    }
+    else {
+        drawableTrapezoidalMapDataset.swap(builtDataset);
+        drawableTrapezoidalMap.swap(builtTrapezoidalMap);
+        directedAcyclicGraph.swap(builtDirectedAcyclicGraph);
+
+#ifdef ENTRY_GRID_RESOLUTION
+        dagPointLocator.setEntryGridResolution(ENTRY_GRID_RESOLUTION);
+#endif
+
+#ifdef COMPARE_POINT_LOCATORS
+        pointLocatorsCompared = false;
+#endif
+
+        ui->loadSegmentsTimeLabel->setNum(buildTime);
+        ui->addSegmentTimeLabel->setText("");
+        ui->queryTimeLabel->setText("");
+
+        scheduleMemoryUsageUpdate();
+    }
+
+    setBuildRunning(false);
+    updateCanvas();
+
+    if (!buildCancelled && !allBuiltSegmentsInserted) {
+        //Error message cannot add an intersecting segment
+        QMessageBox::warning(this, "Cannot insert all segments",
+            "Some segment have be ignored because they have intersections with other segments, "
+            "or they are degenerate.");
+    }
+}
+
+/**
+ * @brief Enable or disable the canvas clicks, the buttons which change the segments and the selection of the point locator, and show the progress of the build.
+ * @param[in] running True when a build starts, false when it ends
+ */
+void TrapezoidalMapManager::setBuildRunning(const bool& running)
+{
+    if (running)
+        disconnect(&mainWindow.canvas, SIGNAL(point2DClicked(cg3::Point2d)), this, SLOT(point2DClicked(cg3::Point2d)));
+    else
+        connect(&mainWindow.canvas, SIGNAL(point2DClicked(cg3::Point2d)), this, SLOT(point2DClicked(cg3::Point2d)));
+
+    ui->loadSegmentsButton->setEnabled(!running);
+    ui->randomSegmentsButton->setEnabled(!running);
+    ui->saveSegmentsButton->setEnabled(!running);
+    ui->loadQueriesButton->setEnabled(!running);
+    ui->clearSegmentsButton->setEnabled(!running);
+    ui->addSegmentRadio->setEnabled(!running);
+    ui->queryRadio->setEnabled(!running);
+    ui->pointLocatorComboBox->setEnabled(!running);
+
+    ui->buildProgressBar->setMaximum(0);
+    ui->buildProgressBar->setValue(0);
+    ui->buildProgressBar->setVisible(running);
+    ui->cancelBuildButton->setEnabled(running);
+    ui->cancelBuildButton->setVisible(running);
+}
+
+/**
+ * @brief Cancel build button event handler. The worker thread stops at the next segment and the drawn segments are kept.
+ */
+void TrapezoidalMapManager::on_cancelBuildButton_clicked()
+{
+    buildCancelled = true;
+    ui->cancelBuildButton->setEnabled(false);
+}
+
+#ifdef COMPARE_POINT_LOCATORS
+/**
+ * @brief Compare the query time of all point locators on the same random points
+ * @param[in] queryNumber Number of random query points
+ */
+void TrapezoidalMapManager::comparePointLocators(const size_t& queryNumber)
+{
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> dist(-BOUNDINGBOX + 1, BOUNDINGBOX - 1);
+    std::vector<cg3::Point2d> queryPoints;
+    std::vector<size_t> firstResults, results;
+
+    for (size_t i = 0; i < queryNumber; i++)
+        queryPoints.push_back(cg3::Point2d(dist(rng), dist(rng)));
+
+    std::cout << "Comparing the point locators on " << queryNumber << " random points..." << std::endl;
+
+    for (PointLocator* locator : pointLocators) {
+        //The first query builds the structure of the point locator, if it is not up to date
+        locator->query(queryPoints.front());
+
+        cg3::Timer timer(locator->getName() + " queries");
+        locator->queryBatch(queryPoints, results);
+        timer.stopAndPrint();
+
+        if (firstResults.empty())
+            firstResults = results;
+
+        std::cout << "Memory usage: " << locator->memoryUsage() << " bytes besides the directed acyclic graph, different results from "
+                  << pointLocators.front()->getName() << ": "
+                  << queryNumber - static_cast<size_t>(std::inner_product(firstResults.begin(), firstResults.end(), results.begin(), size_t(0),
+                                                                           std::plus<size_t>(), std::equal_to<size_t>()))
+                  << std::endl;
+    }
 
     std::cout << std::endl;
 }
+#endif
+
+
+
+//#####################################################################
+
+
+
+
+
+
+//----------------------------------------------------------------------------------------------
+//              You will probably not need to write/edit code in the area below.
+//----------------------------------------------------------------------------------------------
+
+
+/* ----- Private utility methods (DO NOT WRITE CODE IN THESE METHODS) ----- */
 
 /**
  * @brief Launch the method for adding a segment to the trapezoidal map
@@ -479,7 +954,7 @@ void TrapezoidalMapManager::point2DClicked(cg3::Point2d point) //Do not write co
                     //Error message cannot add an intersecting segment
                     QMessageBox::warning(this, "Cannot insert segment",
                         "The segment will be ignored because it has intersections with other segments, "
-                        "it is degenerate, or a point has the same x-coordinate of another point.");
+                        "or it is degenerate.");
                 }
 
                 isFirstPointSelected = false;
@@ -503,7 +978,7 @@ void TrapezoidalMapManager::point2DClicked(cg3::Point2d point) //Do not write co
  *
  * Load input segments from a file.
  */
-void TrapezoidalMapManager::on_loadSegmentsButton_clicked() //Do not write code here
+void TrapezoidalMapManager::on_loadSegmentsButton_clicked()
 {
     //File selector
     QString filename = QFileDialog::getOpenFileName(nullptr,
@@ -518,38 +993,12 @@ void TrapezoidalMapManager::on_loadSegmentsButton_clicked() //Do not write code
             mainWindow.deleteDrawableObject(&firstPointSelected);
         }
 
-        //Clear current data
-        clearTrapezoidalMap();
-        drawableTrapezoidalMapDataset.clear();
-
-        //Load input segments in the vector (deleting the previous ones)
-        std::vector<cg3::Segment2d> segments = FileUtils::getSegmentsFromFile(filename.toStdString());
-
-        //Add to the dataset
-        bool allSegmentInserted = true;
-        for (const cg3::Segment2d& segment : segments) {
-            bool insertedSegment;
-            drawableTrapezoidalMapDataset.addSegment(segment, insertedSegment);
-
-            allSegmentInserted &= insertedSegment;
-            if (!insertedSegment) {
-                std::cout << "The segment " << segment <<
-                    " will be ignored because it has intersections with other segments, "
-                    "it is degenerate, or a point has the same x-coordinate of another point." << std::endl;
-            }
-        }
-        if (!allSegmentInserted) {
-            //Error message cannot add an intersecting segment
-            QMessageBox::warning(this, "Cannot insert all segments",
-                "Some segment have be ignored because they have intersections with other segments, "
-                "they are degenerate, or a point has the same x-coordinate of another point.");
-        }
-
-        //Launch the algorithm on the current vector of segments and measure
-        //its efficiency with a timer
-        loadSegmentsTrapezoidalMapAndMeasureTime(segments);
+        //Load input segments, add them to the dataset and launch the algorithm on a worker thread:
+        //the current data is replaced when the build ends
+        const std::string segmentFile = filename.toStdString();
+        startBuild([segmentFile]() { return FileUtils::getSegmentsFromFile(segmentFile); });
 
-        //The trapezoidal map has been changed, so we update the canvas for drawing.
+        //The first point selected has been removed, so we update the canvas for drawing.
         updateCanvas();
     }
 }
@@ -560,11 +1009,9 @@ void TrapezoidalMapManager::on_loadSegmentsButton_clicked() //Do not write code
  * With this button we can generate files that contains
  * segments which are inside the bounding box.
  */
-void TrapezoidalMapManager::on_randomSegmentsButton_clicked() //Do not write code here
+void TrapezoidalMapManager::on_randomSegmentsButton_clicked()
 {
-    int number = ui->numberRandomSpinBox->value();
-
-    std::vector<cg3::Segment2d> segments = generateRandomNonIntersectingSegments(static_cast<size_t>(number), BOUNDINGBOX);
+    const size_t number = static_cast<size_t>(ui->numberRandomSpinBox->value());
 
     //Cancel first point selected
     if (isFirstPointSelected) {
@@ -572,21 +1019,11 @@ void TrapezoidalMapManager::on_randomSegmentsButton_clicked() //Do not write cod
         mainWindow.deleteDrawableObject(&firstPointSelected);
     }
 
-    //Clear current data
-    clearTrapezoidalMap();
-    drawableTrapezoidalMapDataset.clear();
-
-    for (const cg3::Segment2d& segment : segments) {
-        bool insertedSegment;
-        drawableTrapezoidalMapDataset.addSegment(segment, insertedSegment);
-        assert(insertedSegment);
-    }
-
-    //Launch the algorithm on the current vector of segments and measure
-    //its efficiency with a timer
-    loadSegmentsTrapezoidalMapAndMeasureTime(segments);
+    //Generate the segments, add them to the dataset and launch the algorithm on a worker thread:
+    //the current data is replaced when the build ends
+    startBuild([this, number]() { return generateRandomNonIntersectingSegments(number, BOUNDINGBOX); });
 
-    //The trapezoidal map has been changed, so we update the canvas for drawing.
+    //The first point selected has been removed, so we update the canvas for drawing.
     updateCanvas();
 }
 
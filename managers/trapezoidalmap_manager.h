@@ -2,6 +2,11 @@
 #define VORONOIMANAGER_H
 
 #include <QFrame>
+#include <QTimer>
+
+#include <atomic>
+#include <functional>
+#include <thread>
 
 #include <cg3/viewer/mainwindow.h>
 
@@ -14,6 +19,11 @@
 
 #include "drawables/drawable_trapezoidalmap.h"
 #include "data_structures/directed_acyclic_graph.h"
+#include "data_structures/trapezoidalmap_progress.h"
+#include "data_structures/latency_histogram.h"
+#include "locators/dag_point_locator.h"
+#include "locators/slab_point_locator.h"
+#include "locators/persistent_tree_point_locator.h"
 
 namespace Ui {
     class TrapezoidalMapManager;
@@ -63,6 +73,41 @@ private:
     DrawableTrapezoidalMap drawableTrapezoidalMap;
     DirectedAcyclicGraph directedAcyclicGraph;
 
+    DagPointLocator dagPointLocator;
+    SlabPointLocator slabPointLocator;
+    PersistentTreePointLocator persistentTreePointLocator;
+
+    std::vector<PointLocator*> pointLocators;
+    PointLocator* pointLocator;
+
+#ifdef COMPARE_POINT_LOCATORS
+    bool pointLocatorsCompared = false;
+#endif
+
+    bool memoryUsageUpdateScheduled = false;
+
+    //Latencies of the queries and of the segments added with the incremental step in this session
+    LatencyHistogram queryLatencies;
+    LatencyHistogram insertLatencies;
+    bool latenciesUpdateScheduled = false;
+
+    //The segments are loaded, validated and inserted by a worker thread in a dataset, a trapezoidal map and a directed acyclic graph
+    //of its own, which are swapped with the drawn ones by the interface thread when the build ends
+    TrapezoidalMapDataset builtDataset;
+    TrapezoidalMap builtTrapezoidalMap;
+    DirectedAcyclicGraph builtDirectedAcyclicGraph;
+    DagPointLocator builtPointLocator;
+    TrapezoidalMapProgress builtTrapezoidalMapProgress;
+
+    std::thread buildThread;
+    QTimer buildProgressTimer;
+    std::atomic<bool> buildCancelled;
+    std::atomic<bool> buildFinished;
+    std::atomic<size_t> buildSegmentNumber;
+    std::atomic<size_t> builtSegmentNumber;
+    bool allBuiltSegmentsInserted;
+    double buildTime;
+
     //#####################################################################
 
 
@@ -78,6 +123,18 @@ private:
     //---------------------------------------------------------------------
     //Declare your private methods here if you need some
 
+#ifdef COMPARE_POINT_LOCATORS
+    void comparePointLocators(const size_t& queryNumber);
+#endif
+
+    void scheduleMemoryUsageUpdate();
+    void scheduleLatenciesUpdate();
+
+    void startBuild(const std::function<std::vector<cg3::Segment2d>()>& loadSegments);
+    void build(const std::function<std::vector<cg3::Segment2d>()>& loadSegments);
+    bool appendBuildSnapshot();
+    void finishBuild();
+    void setBuildRunning(const bool& running);
 
 
 
@@ -87,7 +144,6 @@ private:
 
     /* ----- Private utility methods (DO NOT WRITE CODE IN THESE METHODS) ----- */
 
-    void loadSegmentsTrapezoidalMapAndMeasureTime(const std::vector<cg3::Segment2d>& segments);
     void addSegmentToTrapezoidalMapAndMeasureTime(const cg3::Segment2d& segment);
     void queryTrapezoidalMapAndMeasureTime(const cg3::Point2d& point);
     std::vector<cg3::Segment2d> generateRandomNonIntersectingSegments(size_t n, double radius);
@@ -109,6 +165,19 @@ private slots:
     void on_queryRadio_clicked();
     void on_clearSegmentsButton_clicked();
     void on_resetSceneButton_clicked();
+
+    void on_pointLocatorComboBox_currentIndexChanged(int index);
+
+    void updateMemoryUsage();
+
+    void updateLatencies();
+    void on_resetLatenciesButton_clicked();
+
+    void on_loadQueriesButton_clicked();
+    void on_exportLatenciesButton_clicked();
+
+    void on_cancelBuildButton_clicked();
+    void updateBuildProgress();
 };
 
 #endif // VORONOIMANAGER_H
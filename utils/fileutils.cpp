@@ -1,6 +1,8 @@
 #include "fileutils.h"
 
+#include <cstdint>
 #include <fstream>
+#include <limits>
 #include <random>
 #include <iomanip>
 
@@ -56,5 +58,98 @@ std::vector<cg3::Segment2d> saveSegmentsInFile(const std::string& filename, cons
     return segments;
 }
 
+std::vector<cg3::Point2d> getPointsFromFile(const std::string& filename, std::string& error) {
+    std::vector<cg3::Point2d> points;
+    error.clear();
+
+    //A .bin file contains the number of points as a 64 bit integer and the coordinates as doubles,
+    //any other file contains the number of points and the coordinates as text
+    if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0) {
+        std::ifstream infile(filename, std::ios::binary | std::ios::ate);
+
+        if (!infile) {
+            error = "The file cannot be opened.";
+            return points;
+        }
+
+        //The number of points is checked against the size of the file before the coordinates are allocated
+        const uint64_t fileSize = static_cast<uint64_t>(infile.tellg());
+        infile.seekg(0);
+
+        uint64_t n = 0;
+        if (fileSize < sizeof(n) || !infile.read(reinterpret_cast<char*>(&n), sizeof(n))) {
+            error = "The file does not contain the number of points.";
+            return points;
+        }
+
+        if (n > (fileSize - sizeof(n)) / (2 * sizeof(double))) {
+            error = "The file declares " + std::to_string(n) + " points but it is too short to contain them.";
+            return points;
+        }
+
+        std::vector<double> coordinates(2 * static_cast<size_t>(n));
+        if (!infile.read(reinterpret_cast<char*>(coordinates.data()), static_cast<std::streamsize>(coordinates.size() * sizeof(double)))) {
+            error = "The coordinates of the points cannot be read.";
+            return points;
+        }
+
+        points.reserve(static_cast<size_t>(n));
+        for (size_t i = 0; i < coordinates.size(); i += 2)
+            points.push_back(cg3::Point2d(coordinates[i], coordinates[i + 1]));
+    }
+    else {
+        std::ifstream infile(filename);
+
+        if (!infile) {
+            error = "The file cannot be opened.";
+            return points;
+        }
+
+        long long n = 0;
+        if (!(infile >> n) || n < 0) {
+            error = "The file does not start with the number of points.";
+            return points;
+        }
+
+        for (long long i = 0; i < n; i++) {
+            double x = 0.0;
+            double y = 0.0;
+
+            if (!(infile >> x >> y)) {
+                error = "The coordinates of point " + std::to_string(i + 1) + " of " + std::to_string(n) + " cannot be read.";
+                points.clear();
+                return points;
+            }
+
+            points.push_back(cg3::Point2d(x,y));
+        }
+    }
+
+    return points;
+}
+
+void saveQueryResultsInFile(const std::string& filename, const std::vector<size_t>& trapezoids, const std::vector<size_t>& topSegments, const std::vector<size_t>& bottomSegments) {
+    std::ofstream outfile;
+    outfile.open(filename);
+
+    outfile << trapezoids.size() << std::endl;
+
+    //Each line contains the trapezoid of a point and its top and bottom segments, -1 stands for none
+    for (size_t i = 0; i < trapezoids.size(); i++) {
+        const size_t ids[3] = {trapezoids[i], topSegments[i], bottomSegments[i]};
+
+        for (size_t j = 0; j < 3; j++) {
+            if (ids[j] == std::numeric_limits<size_t>::max())
+                outfile << -1;
+            else
+                outfile << ids[j];
+
+            outfile << (j < 2 ? " " : "\n");
+        }
+    }
+
+    outfile.close();
+}
+
 
 }
@@ -1,6 +1,7 @@
 #ifndef FILEUTILS_H
 #define FILEUTILS_H
 
+#include <string>
 #include <vector>
 #include <cg3/geometry/point2.h>
 #include <cg3/geometry/segment2.h>
@@ -11,6 +12,10 @@ std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename);
 
 std::vector<cg3::Segment2d> saveSegmentsInFile(const std::string& filename, const std::vector<cg3::Segment2d>& segments);
 
+std::vector<cg3::Point2d> getPointsFromFile(const std::string& filename, std::string& error);
+
+void saveQueryResultsInFile(const std::string& filename, const std::vector<size_t>& trapezoids, const std::vector<size_t>& topSegments, const std::vector<size_t>& bottomSegments);
+
 }
 
 #endif // FILEUTILS_H
@@ -1,5 +1,13 @@
 #include "geometric_utils.h"
 
+#include <limits>
+
+#include <cg3/geometry/utils2.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 /**
  * @brief geometricUtils::slope returns the slope of the segment.
  * @param segment is the segment whose slope to calculate.
@@ -16,7 +24,304 @@ double geometricUtils::slope(const cg3::Segment2d& segment) {
  * @return the point which has the x coordinate and lies on the segment.
  */
 const cg3::Point2d geometricUtils::intersection(const cg3::Segment2d& segment, const double& x) {
+    // a vertical segment has no slope, its lower point is returned
+    if (segment.p1().x() == segment.p2().x())
+        return cg3::Point2d(x, std::min(segment.p1().y(), segment.p2().y()));
+
     const double& m = slope(segment);
     const double q = segment.p1().y() - m * segment.p1().x();
     return cg3::Point2d(x, m * x + q);
 }
+
+/**
+ * @brief geometricUtils::intersection returns the point which lies on the segment and on the vertical line through the point, in the sheared plane.
+ * For a vertical segment the sheared vertical line crosses it at the y coordinate of the point, which is clamped to the segment.
+ * @param segment is the segment where the point to calculate lies on.
+ * @param point is the point which defines the vertical line.
+ * @return the point which lies on the segment and on the vertical line through the point.
+ */
+const cg3::Point2d geometricUtils::intersection(const cg3::Segment2d& segment, const cg3::Point2d& point) {
+    if (segment.p1().x() == segment.p2().x())
+        return cg3::Point2d(point.x(), std::max(std::min(segment.p1().y(), segment.p2().y()), std::min(point.y(), std::max(segment.p1().y(), segment.p2().y()))));
+
+    return intersection(segment, point.x());
+}
+
+/**
+ * @brief geometricUtils::lineCoefficients computes the coefficients which give the y coordinate of the intersection of the segment with
+ * the vertical line through a point, as intersection does: y = min(max(slope * x + pointYFactor * pointY + intercept, minY), maxY).
+ * A vertical segment has slope 0, pointYFactor 1 and intercept 0, so the y coordinate of the point is clamped to the segment,
+ * any other segment has pointYFactor 0 and no bounds.
+ * @param segment is the segment.
+ * @param coefficients is the array of LINE_COEFFICIENT_NUMBER doubles which receives slope, pointYFactor, intercept, minY and maxY.
+ */
+void geometricUtils::lineCoefficients(const cg3::Segment2d& segment, double* coefficients) {
+    if (segment.p1().x() == segment.p2().x()) {
+        coefficients[0] = 0;
+        coefficients[1] = 1;
+        coefficients[2] = 0;
+        coefficients[3] = std::min(segment.p1().y(), segment.p2().y());
+        coefficients[4] = std::max(segment.p1().y(), segment.p2().y());
+    }
+    else {
+        const double& m = slope(segment);
+        coefficients[0] = m;
+        coefficients[1] = 0;
+        coefficients[2] = segment.p1().y() - m * segment.p1().x();
+        coefficients[3] = -std::numeric_limits<double>::infinity();
+        coefficients[4] = std::numeric_limits<double>::infinity();
+    }
+}
+
+/**
+ * @brief geometricUtils::pointsBefore returns which points are lexicographically smaller than the point, as a point node of the
+ * directed acyclic graph compares them. When the project is compiled with AVX2, four points are compared at once.
+ * @param point is the point of the node.
+ * @param x are the x coordinates of the points.
+ * @param y are the y coordinates of the points.
+ * @param pointNumber is the number of points, at most 64.
+ * @return the mask whose bit i is set if the point is greater than the point i.
+ */
+uint64_t geometricUtils::pointsBefore(const cg3::Point2d& point, const double* x, const double* y, const size_t& pointNumber) {
+    uint64_t mask = 0;
+    size_t first = 0;
+
+#ifdef __AVX2__
+    const __m256d pointX = _mm256_set1_pd(point.x()), pointY = _mm256_set1_pd(point.y());
+
+    for (; first + 4 <= pointNumber; first += 4) {
+        const __m256d otherX = _mm256_loadu_pd(x + first), otherY = _mm256_loadu_pd(y + first);
+        const __m256d sameX = _mm256_cmp_pd(pointX, otherX, _CMP_EQ_OQ);
+        const __m256d before = _mm256_or_pd(_mm256_cmp_pd(pointX, otherX, _CMP_GT_OQ), _mm256_and_pd(sameX, _mm256_cmp_pd(pointY, otherY, _CMP_GT_OQ)));
+
+        mask |= static_cast<uint64_t>(_mm256_movemask_pd(before)) << first;
+    }
+#endif
+
+    for (size_t i = first; i < pointNumber; i++)
+        if (point > cg3::Point2d(x[i], y[i]))
+            mask |= uint64_t(1) << i;
+
+    return mask;
+}
+
+/**
+ * @brief geometricUtils::pointsAtLeft returns which points are at the left of the line through the segment, as cg3::isPointAtLeft does
+ * for a segment node of the directed acyclic graph. When the project is compiled with AVX2, four points are compared at once.
+ * @param segment is the segment of the node.
+ * @param x are the x coordinates of the points.
+ * @param y are the y coordinates of the points.
+ * @param pointNumber is the number of points, at most 64.
+ * @return the mask whose bit i is set if the point i is at the left of the segment.
+ */
+uint64_t geometricUtils::pointsAtLeft(const cg3::Segment2d& segment, const double* x, const double* y, const size_t& pointNumber) {
+    uint64_t mask = 0;
+    size_t first = 0;
+
+#ifdef __AVX2__
+    // the determinant is computed with the same operations of cg3::isPointAtLeft, so the results are the same
+    const __m256d firstX = _mm256_set1_pd(segment.p1().x()), firstY = _mm256_set1_pd(segment.p1().y());
+    const __m256d deltaX = _mm256_set1_pd(segment.p2().x() - segment.p1().x()), deltaY = _mm256_set1_pd(segment.p2().y() - segment.p1().y());
+    const __m256d epsilon = _mm256_set1_pd(std::numeric_limits<double>::epsilon());
+
+    for (; first + 4 <= pointNumber; first += 4) {
+        const __m256d otherX = _mm256_loadu_pd(x + first), otherY = _mm256_loadu_pd(y + first);
+        const __m256d determinant = _mm256_sub_pd(_mm256_mul_pd(deltaX, _mm256_sub_pd(otherY, firstY)), _mm256_mul_pd(deltaY, _mm256_sub_pd(otherX, firstX)));
+
+        mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(determinant, epsilon, _CMP_GT_OQ))) << first;
+    }
+#endif
+
+    for (size_t i = first; i < pointNumber; i++)
+        if (cg3::isPointAtLeft(segment, cg3::Point2d(x[i], y[i])))
+            mask |= uint64_t(1) << i;
+
+    return mask;
+}
+
+/**
+ * @brief geometricUtils::trapezoidCorners computes the corners of many trapezoids from the coefficients of their lines, without divisions.
+ * The corners of each trapezoid are the lower left, the upper left, the upper right and the lower right one, as 8 doubles.
+ * When the project is compiled with AVX2, four trapezoids are computed at once, gathering their coefficients and points.
+ * @param lineCoefficients are the coefficients of the lines, LINE_COEFFICIENT_NUMBER for each line.
+ * @param pointCoordinates are the x and y coordinates of the points.
+ * @param trapezoidLinesAndPoints are the top line, the bottom line, the left point and the right point of each trapezoid.
+ * @param trapezoidNumber is the number of trapezoids.
+ * @param corners is the array of 8 * trapezoidNumber doubles which receives the corners.
+ */
+void geometricUtils::trapezoidCorners(const double* lineCoefficients, const double* pointCoordinates, const size_t* trapezoidLinesAndPoints, const size_t& trapezoidNumber, double* corners) {
+    size_t first = 0;
+
+#ifdef __AVX2__
+    static_assert(sizeof(size_t) == sizeof(long long), "the indexes are gathered as 64 bit integers");
+
+    // the indexes of four trapezoids are transposed, so each vector contains the same index of all trapezoids
+    const __m256i lineStride = _mm256_set1_epi64x(static_cast<long long>(LINE_COEFFICIENT_NUMBER));
+
+    for (; first + 4 <= trapezoidNumber; first += 4) {
+        const __m256i* indexes = reinterpret_cast<const __m256i*>(trapezoidLinesAndPoints + 4 * first);
+        const __m256i t0 = _mm256_loadu_si256(indexes), t1 = _mm256_loadu_si256(indexes + 1);
+        const __m256i t2 = _mm256_loadu_si256(indexes + 2), t3 = _mm256_loadu_si256(indexes + 3);
+
+        const __m256i lo01 = _mm256_unpacklo_epi64(t0, t1), hi01 = _mm256_unpackhi_epi64(t0, t1);
+        const __m256i lo23 = _mm256_unpacklo_epi64(t2, t3), hi23 = _mm256_unpackhi_epi64(t2, t3);
+
+        const __m256i topLines = _mm256_mul_epu32(_mm256_permute2x128_si256(lo01, lo23, 0x20), lineStride);
+        const __m256i bottomLines = _mm256_mul_epu32(_mm256_permute2x128_si256(hi01, hi23, 0x20), lineStride);
+        const __m256i leftPoints = _mm256_slli_epi64(_mm256_permute2x128_si256(lo01, lo23, 0x31), 1);
+        const __m256i rightPoints = _mm256_slli_epi64(_mm256_permute2x128_si256(hi01, hi23, 0x31), 1);
+
+        const __m256d leftX = _mm256_i64gather_pd(pointCoordinates, leftPoints, 8);
+        const __m256d leftY = _mm256_i64gather_pd(pointCoordinates + 1, leftPoints, 8);
+        const __m256d rightX = _mm256_i64gather_pd(pointCoordinates, rightPoints, 8);
+        const __m256d rightY = _mm256_i64gather_pd(pointCoordinates + 1, rightPoints, 8);
+
+        __m256d y[4];
+        const __m256i lines[2] = {bottomLines, topLines};
+
+        // lower left, upper left, upper right and lower right corner
+        for (size_t corner = 0; corner < 4; corner++) {
+            const __m256i& line = lines[corner == 1 || corner == 2];
+            const __m256d& x = corner < 2 ? leftX : rightX;
+            const __m256d& pointY = corner < 2 ? leftY : rightY;
+
+            __m256d value = _mm256_mul_pd(_mm256_i64gather_pd(lineCoefficients, line, 8), x);
+            value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_i64gather_pd(lineCoefficients + 1, line, 8), pointY));
+            value = _mm256_add_pd(value, _mm256_i64gather_pd(lineCoefficients + 2, line, 8));
+            y[corner] = _mm256_min_pd(_mm256_max_pd(value, _mm256_i64gather_pd(lineCoefficients + 3, line, 8)), _mm256_i64gather_pd(lineCoefficients + 4, line, 8));
+        }
+
+        // the corners are transposed back, so each trapezoid has its 8 coordinates
+        const __m256d leftLower = _mm256_unpacklo_pd(leftX, y[0]), leftLowerOdd = _mm256_unpackhi_pd(leftX, y[0]);
+        const __m256d leftUpper = _mm256_unpacklo_pd(leftX, y[1]), leftUpperOdd = _mm256_unpackhi_pd(leftX, y[1]);
+        const __m256d rightUpper = _mm256_unpacklo_pd(rightX, y[2]), rightUpperOdd = _mm256_unpackhi_pd(rightX, y[2]);
+        const __m256d rightLower = _mm256_unpacklo_pd(rightX, y[3]), rightLowerOdd = _mm256_unpackhi_pd(rightX, y[3]);
+
+        double* output = corners + 8 * first;
+        _mm256_storeu_pd(output, _mm256_permute2f128_pd(leftLower, leftUpper, 0x20));
+        _mm256_storeu_pd(output + 4, _mm256_permute2f128_pd(rightUpper, rightLower, 0x20));
+        _mm256_storeu_pd(output + 8, _mm256_permute2f128_pd(leftLowerOdd, leftUpperOdd, 0x20));
+        _mm256_storeu_pd(output + 12, _mm256_permute2f128_pd(rightUpperOdd, rightLowerOdd, 0x20));
+        _mm256_storeu_pd(output + 16, _mm256_permute2f128_pd(leftLower, leftUpper, 0x31));
+        _mm256_storeu_pd(output + 20, _mm256_permute2f128_pd(rightUpper, rightLower, 0x31));
+        _mm256_storeu_pd(output + 24, _mm256_permute2f128_pd(leftLowerOdd, leftUpperOdd, 0x31));
+        _mm256_storeu_pd(output + 28, _mm256_permute2f128_pd(rightUpperOdd, rightLowerOdd, 0x31));
+    }
+#endif
+
+    for (size_t trapezoid = first; trapezoid < trapezoidNumber; trapezoid++) {
+        const size_t* linesAndPoints = trapezoidLinesAndPoints + 4 * trapezoid;
+        const double* lines[2] = {lineCoefficients + LINE_COEFFICIENT_NUMBER * linesAndPoints[1], lineCoefficients + LINE_COEFFICIENT_NUMBER * linesAndPoints[0]};
+        const double* points[2] = {pointCoordinates + 2 * linesAndPoints[2], pointCoordinates + 2 * linesAndPoints[3]};
+
+        // lower left, upper left, upper right and lower right corner
+        for (size_t corner = 0; corner < 4; corner++) {
+            const double* line = lines[corner == 1 || corner == 2];
+            const double* point = points[corner >= 2];
+
+            double value = line[0] * point[0];
+            value = value + line[1] * point[1];
+            value = value + line[2];
+
+            corners[8 * trapezoid + 2 * corner] = point[0];
+            corners[8 * trapezoid + 2 * corner + 1] = std::min(std::max(value, line[3]), line[4]);
+        }
+    }
+}
+
+/**
+ * @brief geometricUtils::clip returns whether the segment intersects the window and computes the x interval of the segment which lies inside it.
+ * @param segment is the segment to be clipped, its first point is the left one.
+ * @param window is the axis-aligned rectangle used to clip the segment.
+ * @param minX is the left x coordinate of the clipped segment.
+ * @param maxX is the right x coordinate of the clipped segment.
+ * @return true if the segment intersects the window, otherwise false.
+ */
+bool geometricUtils::clip(const cg3::Segment2d& segment, const cg3::BoundingBox2& window, double& minX, double& maxX) {
+    minX = std::max(segment.p1().x(), window.min().x());
+    maxX = std::min(segment.p2().x(), window.max().x());
+
+    if (minX > maxX)
+        return false;
+
+    // a vertical segment only has to overlap the window along the y axis
+    if (segment.p1().x() == segment.p2().x())
+        return std::min(segment.p1().y(), segment.p2().y()) <= window.max().y() && std::max(segment.p1().y(), segment.p2().y()) >= window.min().y();
+
+    const double& m = slope(segment);
+
+    // a horizontal segment is inside the window for the whole x interval or for none of it
+    if (m == 0)
+        return segment.p1().y() >= window.min().y() && segment.p1().y() <= window.max().y();
+
+    // restrict the x interval to the one where the segment is between the bottom and the top side of the window
+    const double minYX = segment.p1().x() + (window.min().y() - segment.p1().y()) / m;
+    const double maxYX = segment.p1().x() + (window.max().y() - segment.p1().y()) / m;
+
+    minX = std::max(minX, std::min(minYX, maxYX));
+    maxX = std::min(maxX, std::max(minYX, maxYX));
+
+    return minX <= maxX;
+}
+
+/**
+ * @brief geometricUtils::clip returns whether a part of the segment, which is not a single point, lies in the vertical slab and computes it.
+ * The points of the segment inside the slab or on its sides are kept as they are, so only the points strictly beyond the slab sides
+ * are computed. A segment which only touches a slab side with an endpoint does not lie in the slab, otherwise its clipped part would be
+ * a sliver computed with rounding errors. A vertical segment on a slab side lies in the slab.
+ * @param segment is the segment to be clipped.
+ * @param minX is the left x coordinate of the slab.
+ * @param maxX is the right x coordinate of the slab.
+ * @param clippedSegment is the part of the segment which lies in the slab, its first point is the left one.
+ * @return true if a part of the segment, which is not a single point, lies in the slab, otherwise false.
+ */
+bool geometricUtils::clip(const cg3::Segment2d& segment, const double& minX, const double& maxX, cg3::Segment2d& clippedSegment) {
+    const cg3::Point2d& leftPoint = (segment.p2() < segment.p1()) ? segment.p2() : segment.p1();
+    const cg3::Point2d& rightPoint = (segment.p2() < segment.p1()) ? segment.p1() : segment.p2();
+
+    if (rightPoint.x() < minX || leftPoint.x() > maxX)
+        return false;
+
+    if (leftPoint.x() != rightPoint.x() && (rightPoint.x() <= minX || leftPoint.x() >= maxX))
+        return false;
+
+    const cg3::Segment2d orderedSegment(leftPoint, rightPoint);
+
+    clippedSegment.setP1((leftPoint.x() < minX) ? intersection(orderedSegment, minX) : leftPoint);
+    clippedSegment.setP2((rightPoint.x() > maxX) ? intersection(orderedSegment, maxX) : rightPoint);
+
+    return clippedSegment.p1() != clippedSegment.p2();
+}
+
+/**
+ * @brief geometricUtils::intersects returns whether the trapezoid bounded by the two segments and the two points intersects the window.
+ * The trapezoid clipped to the window x interval is a convex quadrilateral, so it is enough to check that the window is not entirely above its top side or below its bottom side.
+ * A trapezoid whose points share the x coordinate has no width, it is the vertical line between its lowest and its highest corner.
+ * @param topSegment is the top segment of the trapezoid.
+ * @param bottomSegment is the bottom segment of the trapezoid.
+ * @param leftPoint is the left point of the trapezoid.
+ * @param rightPoint is the right point of the trapezoid.
+ * @param window is the axis-aligned rectangle.
+ * @return true if the trapezoid intersects the window, otherwise false.
+ */
+bool geometricUtils::intersects(const cg3::Segment2d& topSegment, const cg3::Segment2d& bottomSegment, const cg3::Point2d& leftPoint, const cg3::Point2d& rightPoint, const cg3::BoundingBox2& window) {
+    const double minX = std::max(leftPoint.x(), window.min().x());
+    const double maxX = std::min(rightPoint.x(), window.max().x());
+
+    if (minX > maxX)
+        return false;
+
+    if (leftPoint.x() == rightPoint.x())
+        return window.min().y() <= std::max(intersection(topSegment, leftPoint).y(), intersection(topSegment, rightPoint).y())
+                && window.max().y() >= std::min(intersection(bottomSegment, leftPoint).y(), intersection(bottomSegment, rightPoint).y());
+
+    // the window is entirely above the top side of the trapezoid
+    if (window.min().y() > intersection(topSegment, minX).y() && window.min().y() > intersection(topSegment, maxX).y())
+        return false;
+
+    // the window is entirely below the bottom side of the trapezoid
+    if (window.max().y() < intersection(bottomSegment, minX).y() && window.max().y() < intersection(bottomSegment, maxX).y())
+        return false;
+
+    return true;
+}
@@ -1,12 +1,29 @@
 #ifndef GEOMETRIC_UTILS_H
 #define GEOMETRIC_UTILS_H
 
+#include <cstdint>
+
 #include <cg3/geometry/segment2.h>
 #include <cg3/geometry/point2.h>
+#include <cg3/geometry/bounding_box2.h>
 
 namespace geometricUtils {
+    // slope, factor of the y coordinate of the point, intercept, minimum and maximum y of a line, see lineCoefficients
+    const size_t LINE_COEFFICIENT_NUMBER = 5;
+
     double slope(const cg3::Segment2d& segment);
     const cg3::Point2d intersection(const cg3::Segment2d& segment, const double& x);
+    const cg3::Point2d intersection(const cg3::Segment2d& segment, const cg3::Point2d& point);
+
+    void lineCoefficients(const cg3::Segment2d& segment, double* coefficients);
+    uint64_t pointsBefore(const cg3::Point2d& point, const double* x, const double* y, const size_t& pointNumber);
+    uint64_t pointsAtLeft(const cg3::Segment2d& segment, const double* x, const double* y, const size_t& pointNumber);
+
+    void trapezoidCorners(const double* lineCoefficients, const double* pointCoordinates, const size_t* trapezoidLinesAndPoints, const size_t& trapezoidNumber, double* corners);
+
+    bool clip(const cg3::Segment2d& segment, const cg3::BoundingBox2& window, double& minX, double& maxX);
+    bool clip(const cg3::Segment2d& segment, const double& minX, const double& maxX, cg3::Segment2d& clippedSegment);
+    bool intersects(const cg3::Segment2d& topSegment, const cg3::Segment2d& bottomSegment, const cg3::Point2d& leftPoint, const cg3::Point2d& rightPoint, const cg3::BoundingBox2& window);
 }
 
 #endif // GEOMETRIC_UTILS_H